@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include <chrono>
+#include <random>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/collisionLayer.hpp"
+
+/*
+ * Time taken by box queries against a collisionLayer at 1, 2 and 4
+ * bits per cell, compared with reading each tile of the layer and
+ * looking it up in the attribute table (how game logic would check
+ * without one). Each query checks or sweeps a box a few tiles across,
+ * as a character or projectile would, at a random spot on a 4096x4096
+ * layer whose tiles are too large to stay in cache. The layer and
+ * boxes are generated from a fixed seed.
+ */
+
+namespace {
+    typedef std::chrono::steady_clock benchClock;
+    typedef fdl::keroBlaster::pxPack pxPack;
+    typedef fdl::keroBlaster::collisionLayer collisionLayer;
+    
+    constexpr uint16_t WIDTH = 4096;
+    constexpr uint16_t HEIGHT = 4096;
+    constexpr int NUM_QUERIES = 1 << 20;
+    
+    volatile size_t sink; //keeps results alive so the optimizer can't drop the work being timed
+    
+    struct box {
+        int32_t x, y;
+        uint32_t width, height;
+        int32_t dx;
+    };
+    
+    template <typename F>
+    double nanosecondsPerQuery(F f) {
+        f(); //warm up caches
+        
+        const benchClock::time_point START = benchClock::now();
+        f();
+        
+        return std::chrono::duration <double, std::nano>(benchClock::now() - START).count() / NUM_QUERIES;
+    }
+    
+    void report(const std::string& name, const double NANOSECONDS) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << NANOSECONDS << " ns/query\n";
+    }
+}
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    std::mt19937 rng(0);
+    
+    //about one tile in eight is solid, as in a typical level
+    std::vector <uint8_t> tiles((size_t)WIDTH * HEIGHT);
+    for (uint8_t& tile : tiles) {
+        tile = ((0 == rng() % 8) ? 1 + rng() % 15 : 0);
+    }
+    
+    pxPack::tileLayer layer;
+    layer.setTiles(WIDTH, HEIGHT, tiles.data());
+    
+    std::vector <box> boxes(NUM_QUERIES);
+    for (box& b : boxes) {
+        b = {(int32_t)(rng() % WIDTH), (int32_t)(rng() % HEIGHT), (uint32_t)(1 + rng() % 4), (uint32_t)(1 + rng() % 4), (int32_t)(rng() % 33) - 16};
+    }
+    
+    for (const int BITS : {1, 2, 4}) {
+        std::array <uint8_t, 256> attributes = {};
+        for (int i = 1; i < 16; ++i) {
+            attributes[i] = i & ((1 << BITS) - 1);
+        }
+        
+        attributes[1] = 1; //tile 1 always holds the solid bit
+        const std::string SUFFIX = ' ' + std::to_string(BITS) + (1 == BITS ? " bit" : " bits");
+        
+        report("tile by tile anyInRect" + SUFFIX, nanosecondsPerQuery([&]() {
+            size_t hits = 0;
+            
+            for (const box& B : boxes) {
+                bool hit = false;
+                
+                for (int32_t y = B.y; y < B.y + (int32_t)B.height && y < HEIGHT && !hit; ++y) {
+                    for (int32_t x = B.x; x < B.x + (int32_t)B.width && x < WIDTH && !hit; ++x) {
+                        hit = (0 != (attributes[layer.getTile(x, y)] & 1));
+                    }
+                }
+                
+                hits += hit;
+            }
+            
+            sink = hits;
+        }));
+        
+        const collisionLayer COLLISION(layer, attributes, BITS);
+        
+        report("anyInRect" + SUFFIX, nanosecondsPerQuery([&]() {
+            size_t hits = 0;
+            
+            for (const box& B : boxes) {
+                hits += COLLISION.anyInRect(B.x, B.y, B.width, B.height, 1);
+            }
+            
+            sink = hits;
+        }));
+        
+        report("sweepHorizontal" + SUFFIX, nanosecondsPerQuery([&]() {
+            size_t moved = 0;
+            
+            for (const box& B : boxes) {
+                moved += COLLISION.sweepHorizontal(B.x, B.y, B.width, B.height, B.dx, 1);
+            }
+            
+            sink = moved;
+        }));
+        
+        report("sweepVertical" + SUFFIX, nanosecondsPerQuery([&]() {
+            size_t moved = 0;
+            
+            for (const box& B : boxes) {
+                moved += COLLISION.sweepVertical(B.x, B.y, B.width, B.height, B.dx, 1);
+            }
+            
+            sink = moved;
+        }));
+    }
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <iomanip>
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include <chrono>
+#include <random>
+
+#include <cstdint>
+#include <cstdlib> //strtoul(const char* str, char** endptr, int base)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/mapRenderer.hpp"
+
+#include "fdl/imageUtil/image.hpp"
+
+/*
+ * Throughput of rendering three tile layers with renderTileLayers()
+ * on one thread and on every hardware thread, with 8x8 and 16x16
+ * tiles, and of encoding the result as PPM and PNG. A tile drawn one
+ * pixel at a time (how a naive renderer would draw them) is timed
+ * alongside for comparison. The tileset mixes empty, opaque and masked
+ * tiles, and layers are generated from a fixed seed.
+ *
+ * Usage: mapRenderBench [width height]
+ * The optional arguments set the size of the layers in tiles (512 512
+ * by default).
+ */
+
+namespace {
+    typedef std::chrono::steady_clock benchClock;
+    typedef fdl::keroBlaster::pxPack pxPack;
+    typedef fdl::keroBlaster::tilesetAtlas tilesetAtlas;
+    
+    volatile size_t sink; //keeps results alive so the optimizer can't drop the work being timed
+    
+    template <typename F>
+    double secondsPerRun(const int RUNS, F f) {
+        f(); //warm up caches
+        
+        const benchClock::time_point START = benchClock::now();
+        
+        for (int i = 0; i < RUNS; ++i) {
+            f();
+        }
+        
+        return std::chrono::duration <double>(benchClock::now() - START).count() / RUNS;
+    }
+    
+    void report(const std::string& name, const double SECONDS, const double BYTES) {
+        std::cout << std::left << std::setw(40) << name << std::right
+                  << std::setw(10) << SECONDS * 1000 << " ms"
+                  << std::setw(12) << BYTES / (1024 * 1024) / SECONDS << " MB/s\n";
+    }
+    
+    //a 16x16 tile tileset whose rows of tiles are empty, opaque or masked in turn
+    fdl::imageUtil::rgbaImage generateTileset(const uint32_t tileSize) {
+        fdl::imageUtil::rgbaImage image(16 * tileSize, 16 * tileSize);
+        std::mt19937 rng(0);
+        
+        for (uint32_t y = 0; y < image.height; ++y) {
+            uint8_t* pixel = image.getRow(y);
+            const uint32_t KIND = (y / tileSize) % 3;
+            
+            for (uint32_t x = 0; x < image.width; ++x, pixel += 4) {
+                if (0 == KIND || (2 == KIND && 0 == (x & 1))) {
+                    continue;
+                }
+                
+                const uint32_t COLOUR = rng();
+                pixel[0] = COLOUR;
+                pixel[1] = COLOUR >> 8;
+                pixel[2] = COLOUR >> 16;
+                pixel[3] = 255;
+            }
+        }
+        
+        return image;
+    }
+    
+    std::array <pxPack::tileLayer, pxPack::NUM_LAYERS> generateLayers(const uint16_t width, const uint16_t height) {
+        std::array <pxPack::tileLayer, pxPack::NUM_LAYERS> layers;
+        std::vector <uint8_t> tiles((size_t)width * height);
+        std::mt19937 rng(0);
+        
+        for (pxPack::tileLayer& layer : layers) {
+            for (uint8_t& tile : tiles) {
+                tile = rng();
+            }
+            
+            layer.setTiles(width, height, tiles.data());
+        }
+        
+        return layers;
+    }
+    
+    void benchRender(const uint16_t width, const uint16_t height, const uint32_t tileSize, const int RUNS) {
+        const std::string SIZE = ' ' + std::to_string(width) + 'x' + std::to_string(height) + " @" + std::to_string(tileSize);
+        
+        const tilesetAtlas ATLAS(generateTileset(tileSize), tileSize);
+        const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS> ATLASES = {{&ATLAS, &ATLAS, &ATLAS}};
+        const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS> LAYERS = generateLayers(width, height);
+        
+        const double BYTES = (double)width * tileSize * height * tileSize * 4;
+        fdl::imageUtil::rgbaImage image;
+        
+        report("pixel by pixel" + SIZE, secondsPerRun(RUNS, [&]() {
+            image = fdl::imageUtil::rgbaImage(width * tileSize, height * tileSize, {{0, 0, 0, 255}});
+            
+            for (int i = pxPack::NUM_LAYERS - 1; i >= 0; --i) {
+                for (uint32_t y = 0; y < image.height; ++y) {
+                    for (uint32_t x = 0; x < image.width; ++x) {
+                        const uint8_t TILE = LAYERS[i].getTile(x / tileSize, y / tileSize);
+                        const uint8_t* const SOURCE = ATLAS.getImage().getRow((TILE / 16) * tileSize + y % tileSize) +
+                                                      ((TILE % 16) * tileSize + x % tileSize) * 4;
+                        
+                        if (0 != SOURCE[3]) {
+                            std::copy(SOURCE, SOURCE + 4, image.getRow(y) + x * 4);
+                        }
+                    }
+                }
+            }
+            
+            sink = image.pixels.back();
+        }), BYTES);
+        
+        fdl::keroBlaster::renderOptions options;
+        options.maxThreads = 1;
+        
+        report("renderTileLayers 1 thread" + SIZE, secondsPerRun(RUNS, [&]() {
+            image = fdl::keroBlaster::renderTileLayers(LAYERS, ATLASES, options);
+            sink = image.pixels.back();
+        }), BYTES);
+        
+        options.maxThreads = 0;
+        
+        report("renderTileLayers all threads" + SIZE, secondsPerRun(RUNS, [&]() {
+            image = fdl::keroBlaster::renderTileLayers(LAYERS, ATLASES, options);
+            sink = image.pixels.back();
+        }), BYTES);
+        
+        report("encodePpm" + SIZE, secondsPerRun(RUNS, [&]() {
+            sink = fdl::imageUtil::encodePpm(image).size();
+        }), BYTES);
+        
+        report("encodePng" + SIZE, secondsPerRun(RUNS, [&]() {
+            sink = fdl::imageUtil::encodePng(image).size();
+        }), BYTES);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << std::fixed << std::setprecision(2);
+    
+    const uint16_t WIDTH = ((argc > 2) ? strtoul(argv[1], nullptr, 10) : 512);
+    const uint16_t HEIGHT = ((argc > 2) ? strtoul(argv[2], nullptr, 10) : 512);
+    
+    benchRender(WIDTH, HEIGHT, 8, 5);
+    benchRender(WIDTH / 2, HEIGHT / 2, 16, 5);
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include <iostream>
+#include <iomanip>
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include <chrono>
+
+#include <exception>
+
+#include <cstdint>
+#include <cstdio> //remove(const char* filename)
+#include <cstdlib> //strtoul(const char* str, char** endptr, int base)
+
+#include "fdl/keroBlaster/keroBlaster.hpp"
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "fdl/containerUtil/containerUtil.hpp"
+#include "fdl/containerUtil/byteKernels.hpp"
+
+#include "pxPackGenerator.hpp"
+
+/*
+ * Microbenchmarks for the PXPACK parsing hot path. Every input is
+ * generated from a fixed seed so numbers are comparable between runs.
+ * Synthetic maps are written to the field folder under the current
+ * directory (basePath ".", resourceFolder "bench") and removed afterwards.
+ *
+ * Usage: pxPackBench [width height numEntities]
+ * The optional arguments set the size of the large map (4096 4096 20000
+ * by default), up to 65535 65535 65535.
+ */
+
+namespace {
+    typedef std::chrono::steady_clock benchClock;
+    typedef fdl::keroBlaster::pxPack pxPack;
+    
+    volatile size_t sink; //keeps results alive so the optimizer can't drop the work being timed
+    
+    template <typename F>
+    double secondsPerRun(const int RUNS, F f) {
+        f(); //warm up caches and the page cache
+        
+        const benchClock::time_point START = benchClock::now();
+        
+        for (int i = 0; i < RUNS; ++i) {
+            f();
+        }
+        
+        return std::chrono::duration <double>(benchClock::now() - START).count() / RUNS;
+    }
+    
+    void report(const std::string& name, const double SECONDS, const double BYTES, const double ITEMS, const char* itemName) {
+        std::cout << std::left << std::setw(40) << name << std::right
+                  << std::setw(10) << SECONDS * 1000 << " ms";
+        
+        if (BYTES > 0) {
+            std::cout << std::setw(12) << BYTES / (1024 * 1024) / SECONDS << " MB/s";
+        }
+        
+        std::cout << std::setw(14) << ITEMS / SECONDS << ' ' << itemName << "/s\n";
+    }
+    
+    void benchLoadMap(const std::string& name, const bench::syntheticPxPackOptions& options, const int RUNS) {
+        const std::string PATH = pxPack::getFolderPath() + name + pxPack::FILE_EXTENSION;
+        const double BYTES = bench::writeSyntheticPxPack(PATH, options);
+        
+        const struct {
+            pxPack::loadMode mode;
+            const char* label;
+        } MODES [] = {{pxPack::LOAD_STREAM, "stream"}, {pxPack::LOAD_MAPPED, "mapped"},
+                      {pxPack::LOAD_MAPPED_ZERO_COPY, "mapped zero-copy"}, {pxPack::LOAD_LAZY, "lazy (head only)"}};
+        
+        for (const auto& mode : MODES) {
+            const double SECONDS = secondsPerRun(RUNS, [&]() {
+                pxPack map(name, mode.mode);
+                sink = map.getDescription().size();
+            });
+            
+            report("loadMap " + std::to_string(options.width) + 'x' + std::to_string(options.height) +
+                   ' ' + mode.label, SECONDS, BYTES, 1, "maps");
+        }
+        
+        remove(PATH.c_str());
+    }
+    
+    void benchReadString(const int RUNS) {
+        //entities are mostly their names, so parsing a map full of them is dominated by string reads
+        bench::syntheticPxPackOptions options;
+        options.width = 0;
+        options.height = 0;
+        options.numEntities = pxPack::MAX_NUM_ENTITIES;
+        options.nameLength = pxPack::entity::NAME_MAX_LEN;
+        
+        const std::vector <uint8_t> FILE = bench::generateSyntheticPxPack(options);
+        
+        pxPack map;
+        const double SECONDS = secondsPerRun(RUNS, [&]() {
+            map.loadFromMemory(FILE);
+            sink = map.entities.size();
+        });
+        
+        report("readString (65535 named entities)", SECONDS, FILE.size(), options.numEntities, "strings");
+    }
+    
+    void benchMalformed(const int RUNS) {
+        //a sweep over user-submitted maps, most of which are cut off or aren't PXPACK files at all
+        bench::syntheticPxPackOptions options;
+        options.numEntities = 100;
+        
+        const std::vector <uint8_t> FILE = bench::generateSyntheticPxPack(options);
+        const size_t NUM_FILES = 1000;
+        
+        pxPack map;
+        
+        report("loadFromMemory (1000 malformed, throwing)", secondsPerRun(RUNS, [&]() {
+            size_t failures = 0;
+            
+            for (size_t i = 0; i < NUM_FILES; ++i) {
+                try {
+                    map.loadFromMemory(FILE.data(), (i * 7919) % 64); //cut off within the head
+                }
+                catch (const std::exception&) {
+                    ++failures;
+                }
+            }
+            
+            sink = failures;
+        }), 0, NUM_FILES, "files");
+        
+        report("tryLoadFromMemory (1000 malformed)", secondsPerRun(RUNS, [&]() {
+            size_t failures = 0;
+            
+            for (size_t i = 0; i < NUM_FILES; ++i) {
+                failures += !map.tryLoadFromMemory(FILE.data(), (i * 7919) % 64);
+            }
+            
+            sink = failures;
+        }), 0, NUM_FILES, "files");
+    }
+    
+    void benchSetDimensions(const int RUNS) {
+        const uint16_t SMALL = 2048, LARGE = 4096;
+        
+        pxPack::tileLayer layer;
+        const double SECONDS = secondsPerRun(RUNS, [&]() {
+            layer.setDimensions(LARGE, LARGE);
+            layer.setDimensions(SMALL, LARGE);
+            layer.setDimensions(LARGE, SMALL);
+            layer.setDimensions(SMALL, SMALL);
+            sink = layer.getWidth();
+        });
+        
+        report("setDimensions (2048 <-> 4096, 4 resizes)", SECONDS, 0, 4, "resizes");
+    }
+    
+    void benchSetTile(const int RUNS) {
+        const uint16_t SIZE = 2048;
+        
+        pxPack::tileLayer layer;
+        layer.setDimensions(SIZE, SIZE);
+        
+        const double SECONDS = secondsPerRun(RUNS, [&]() {
+            for (int j = 0; j < SIZE; ++j) {
+                for (int k = 0; k < SIZE; ++k) {
+                    layer.setTile(k, j, j ^ k);
+                }
+            }
+        });
+        
+        report("setTile (2048x2048 sweep)", SECONDS, (double)SIZE * SIZE, (double)SIZE * SIZE, "tiles");
+    }
+    
+    void benchBulkTileOps(const int RUNS) {
+        const uint16_t SIZE = 4096;
+        const double NUM_TILES = (double)SIZE * SIZE;
+        
+        pxPack::tileLayer a, b;
+        a.setDimensions(SIZE, SIZE);
+        b.setDimensions(SIZE, SIZE);
+        a.fillRect(0, 0, SIZE, SIZE / 2, 3);
+        b.fillRect(SIZE / 4, SIZE / 4, SIZE / 2, SIZE / 2, 3);
+        
+        std::array <uint8_t, 256> table;
+        
+        for (int i = 0; i < 256; ++i) {
+            table[i] = 255 - i;
+        }
+        
+        const std::string TARGET = std::string(" (") + fdl::containerUtil::getByteKernelTarget() + ')';
+        
+        report("fillRect 4096x4096", secondsPerRun(RUNS, [&]() {
+            a.fillRect(0, 0, SIZE, SIZE, 1);
+            a.fillRect(0, 0, SIZE, SIZE / 2, 3);
+        }) / 2, NUM_TILES, NUM_TILES, "tiles");
+        
+        report("replaceTile 4096x4096" + TARGET, secondsPerRun(RUNS, [&]() {
+            sink = a.replaceTile(3, 4) + a.replaceTile(4, 3);
+        }) / 2, NUM_TILES, NUM_TILES, "tiles");
+        
+        report("getHistogram 4096x4096", secondsPerRun(RUNS, [&]() {
+            sink = a.getHistogram()[3];
+        }), NUM_TILES, NUM_TILES, "tiles");
+        
+        report("countDifferences 4096x4096" + TARGET, secondsPerRun(RUNS, [&]() {
+            sink = a.countDifferences(b);
+        }), NUM_TILES * 2, NUM_TILES, "tiles");
+        
+        report("remapTiles 4096x4096" + TARGET, secondsPerRun(RUNS, [&]() {
+            a.remapTiles(a, table);
+        }), NUM_TILES, NUM_TILES, "tiles");
+    }
+    
+    void benchCoordsFromIndex(const int RUNS) {
+        const size_t COUNT = 1 << 24;
+        const size_t WIDTH = 1000;
+        
+        const double SECONDS = secondsPerRun(RUNS, [&]() {
+            size_t total = 0;
+            
+            for (size_t i = 0; i < COUNT; ++i) {
+                const fdl::containerUtil::coordinatePair CP = fdl::containerUtil::coordsFromIndex(i, WIDTH);
+                total += CP.x + CP.y;
+            }
+            
+            sink = total;
+        });
+        
+        report("coordsFromIndex", SECONDS, 0, COUNT, "calls");
+    }
+}
+
+int main(int argc, char** argv) {
+    fdl::keroBlaster::basePath = ".";
+    fdl::keroBlaster::resourceFolder = "bench";
+    
+    std::cout << std::fixed << std::setprecision(2);
+    
+    bench::syntheticPxPackOptions options;
+    benchLoadMap("benchSmall", options, 200); //typical field map
+    
+    options.width = ((argc > 2) ? strtoul(argv[1], nullptr, 10) : 4096);
+    options.height = ((argc > 2) ? strtoul(argv[2], nullptr, 10) : 4096);
+    options.numEntities = ((argc > 3) ? strtoul(argv[3], nullptr, 10) : 20000);
+    benchLoadMap("benchLarge", options, 5);
+    
+    benchReadString(20);
+    benchMalformed(20);
+    benchSetDimensions(5);
+    benchSetTile(5);
+    benchBulkTileOps(10);
+    benchCoordsFromIndex(5);
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <string>
+#include <vector>
+
+#include <fstream>
+#include <sstream>
+
+#include <stdexcept>
+
+#include <cstdint>
+#include <cstring> //strlen(const char* str)
+
+#include "fdl/keroBlaster/keroBlaster.hpp"
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "pxPackGenerator.hpp"
+
+namespace {
+    typedef fdl::keroBlaster::pxPack pxPack;
+    
+    //xorshift32; quick enough that generating huge layers is bound by writing them
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    
+    void writeUInt16(std::ostream& out, const uint16_t value) { //PXPACK files are little-endian
+        out.put(value & 0xFF);
+        out.put(value >> 8);
+    }
+    
+    void writeString(std::ostream& out, const uint8_t length, const int maxLength, const char fill) {
+        const uint8_t LEN = ((length < maxLength) ? length : maxLength);
+        out.put(LEN);
+        out << std::string(LEN, fill);
+    }
+    
+    void writeLayer(std::ostream& out, const uint16_t width, const uint16_t height, uint32_t& state) {
+        out.write(pxPack::LAYER_HEADER, strlen(pxPack::LAYER_HEADER) + 1); //+ 1 to include null terminator, which is in the file
+        writeUInt16(out, width);
+        writeUInt16(out, height);
+        
+        if ((size_t)width * height > 0) {
+            out.put(0); //flag
+            
+            std::vector <char> row(width);
+            
+            for (int i = 0; i < height; ++i) {
+                for (char& tile : row) {
+                    tile = nextRandom(state);
+                }
+                
+                out.write(row.data(), row.size());
+            }
+        }
+    }
+}
+
+namespace bench {
+    void writeSyntheticPxPack(std::ostream& out, const syntheticPxPackOptions& options) {
+        uint32_t state = options.seed * 2654435761u + 1; //xorshift state can't be 0
+        
+        out.write(pxPack::HEADER, strlen(pxPack::HEADER) + 1); //+ 1 to include null-terminator, which appears in the file
+        
+        writeString(out, options.nameLength, pxPack::DESCRIPTION_MAX_LEN, 'd');
+        writeString(out, options.nameLength, fdl::keroBlaster::FILENAME_MAX_LEN, 's');
+        
+        for (int i = 0; i < pxPack::NUM_REFERENCED_MAPS; ++i) {
+            writeString(out, options.nameLength, fdl::keroBlaster::FILENAME_MAX_LEN, 'm');
+        }
+        
+        writeString(out, options.nameLength, fdl::keroBlaster::FILENAME_MAX_LEN, 'p');
+        out << std::string(pxPack::NUM_UNKNOWN_HEAD_BYTES, '\0');
+        
+        for (int i = 0; i < pxPack::NUM_REFERENCED_TILESETS; ++i) {
+            writeString(out, options.nameLength, fdl::keroBlaster::FILENAME_MAX_LEN, 't');
+            out << std::string(pxPack::NUM_UNKNOWN_TILESET_BYTES, '\0');
+        }
+        
+        writeLayer(out, options.width, options.height, state);
+        writeLayer(out, options.width, options.height, state);
+        writeLayer(out, options.width / 2, options.height / 2, state);
+        
+        const uint16_t NUM_ENTITIES = ((options.numEntities < pxPack::MAX_NUM_ENTITIES) ?
+                                       options.numEntities : pxPack::MAX_NUM_ENTITIES);
+        writeUInt16(out, NUM_ENTITIES);
+        
+        for (int i = 0; i < NUM_ENTITIES; ++i) {
+            const uint32_t VALUE = nextRandom(state);
+            
+            out.put(VALUE & 0x01); //flag
+            out.put((VALUE >> 8) & 0xFF); //type
+            out.put(0); //unknown byte
+            writeUInt16(out, (options.width > 0) ? nextRandom(state) % options.width : 0); //x
+            writeUInt16(out, (options.height > 0) ? nextRandom(state) % options.height : 0); //y
+            out << std::string(pxPack::NUM_UNKNOWN_ENTITY_BYTES, '\0');
+            writeString(out, options.nameLength, pxPack::entity::NAME_MAX_LEN, 'e');
+        }
+    }
+    
+    uint64_t writeSyntheticPxPack(const std::string& path, const syntheticPxPackOptions& options) {
+        std::ofstream file(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+        
+        writeSyntheticPxPack(file, options);
+        const uint64_t SIZE = file.tellp();
+        file.close();
+        
+        if (!file.good()) {
+            throw std::runtime_error("ERROR: Failed to write synthetic PXPACK file " + path + '.');
+        }
+        
+        return SIZE;
+    }
+    
+    std::vector <uint8_t> generateSyntheticPxPack(const syntheticPxPackOptions& options) {
+        std::ostringstream out(std::ostringstream::out | std::ostringstream::binary);
+        writeSyntheticPxPack(out, options);
+        
+        const std::string BYTES = out.str();
+        return std::vector <uint8_t>(BYTES.begin(), BYTES.end());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef PXPACKGENERATOR_HPP
+#define PXPACKGENERATOR_HPP
+
+#include <string>
+#include <vector>
+
+#include <ostream>
+
+#include <cstdint>
+
+namespace bench {
+    /**
+     * Describes the synthetic PXPACK file to generate.
+     */
+    struct syntheticPxPackOptions {
+        uint16_t width = 400; /**< Width of the first two layers; the third is half as wide */
+        uint16_t height = 300; /**< Height of the first two layers; the third is half as tall */
+        uint32_t numEntities = 1000; /**< Clamped to fdl::keroBlaster::pxPack::MAX_NUM_ENTITIES */
+        uint8_t nameLength = 15; /**< Length of every string, clamped to each string's maximum length */
+        uint32_t seed = 0; /**< Seed for the tiles and entity values, so files are reproducible */
+    };
+    
+    /**
+     * Writes a valid synthetic PXPACK file to the given stream.
+     * Tiles are written a row at a time, so layers as large as
+     * 65535x65535 can be generated without holding them in memory.
+     */
+    void writeSyntheticPxPack(std::ostream& out, const syntheticPxPackOptions& options);
+    
+    /**
+     * Writes a valid synthetic PXPACK file to the given path.
+     *
+     * @return The size of the file in bytes.
+     */
+    uint64_t writeSyntheticPxPack(const std::string& path, const syntheticPxPackOptions& options);
+    
+    /**
+     * @return A valid synthetic PXPACK file held in memory.
+     */
+    std::vector <uint8_t> generateSyntheticPxPack(const syntheticPxPackOptions& options);
+}
+
+#endif //PXPACKGENERATOR_HPP
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+
+#include <string>
+#include <vector>
+
+#include <fstream>
+
+#include <chrono>
+#include <random>
+
+#include <cstdint>
+#include <cstdio> //remove(const char* filename)
+#include <cstdlib> //strtoul(const char* str, char** endptr, int base)
+
+#include "fdl/caveStory/pxm.hpp"
+
+/*
+ * Throughput of loading PXM files through each input path: a file
+ * read through a stream, a memory-mapped file and a buffer already in
+ * memory. A stream read tile by tile (how a naive loader would read
+ * them) is timed alongside for comparison. Maps are generated from a
+ * fixed seed, written to the current directory and removed afterwards.
+ *
+ * Usage: pxmBench [width height]
+ * The optional arguments set the size of the large map (4096 4096 by
+ * default), up to 65535 65535.
+ */
+
+namespace {
+    typedef std::chrono::steady_clock benchClock;
+    typedef fdl::caveStory::pxm pxm;
+    
+    volatile size_t sink; //keeps results alive so the optimizer can't drop the work being timed
+    
+    template <typename F>
+    double secondsPerRun(const int RUNS, F f) {
+        f(); //warm up caches and the page cache
+        
+        const benchClock::time_point START = benchClock::now();
+        
+        for (int i = 0; i < RUNS; ++i) {
+            f();
+        }
+        
+        return std::chrono::duration <double>(benchClock::now() - START).count() / RUNS;
+    }
+    
+    void report(const std::string& name, const double SECONDS, const double BYTES) {
+        std::cout << std::left << std::setw(40) << name << std::right
+                  << std::setw(10) << SECONDS * 1000 << " ms"
+                  << std::setw(12) << BYTES / (1024 * 1024) / SECONDS << " MB/s\n";
+    }
+    
+    std::vector <uint8_t> generatePxm(const uint16_t width, const uint16_t height) {
+        std::vector <uint8_t> file = {'P', 'X', 'M', 0x10, (uint8_t)width, (uint8_t)(width >> 8),
+                                      (uint8_t)height, (uint8_t)(height >> 8)};
+        
+        std::mt19937 rng(0);
+        const size_t NUM_TILES = (size_t)width * height;
+        file.reserve(file.size() + NUM_TILES);
+        
+        for (size_t i = 0; i < NUM_TILES; ++i) {
+            file.push_back(rng() & 0x7F);
+        }
+        
+        return file;
+    }
+    
+    void benchLoad(const uint16_t width, const uint16_t height, const int RUNS) {
+        const std::string PATH = "pxmBench" + std::string(pxm::FILE_EXTENSION);
+        const std::string SIZE = ' ' + std::to_string(width) + 'x' + std::to_string(height);
+        
+        const std::vector <uint8_t> FILE = generatePxm(width, height);
+        const double BYTES = FILE.size();
+        
+        {
+            std::ofstream out(PATH, std::ofstream::out | std::ofstream::binary);
+            out.write((const char*)FILE.data(), FILE.size());
+        }
+        
+        pxm map;
+        
+        report("tile by tile stream" + SIZE, secondsPerRun(RUNS, [&]() {
+            std::ifstream in(PATH, std::ifstream::in | std::ifstream::binary);
+            in.ignore(pxm::HEAD_SIZE);
+            
+            std::vector <uint8_t> tiles((size_t)width * height);
+            
+            for (uint8_t& tile : tiles) {
+                tile = in.get();
+            }
+            
+            sink = tiles.back();
+        }), BYTES);
+        
+        report("loadMap stream" + SIZE, secondsPerRun(RUNS, [&]() {
+            map.loadMap(PATH, pxm::LOAD_STREAM);
+            sink = map.getTiles().size();
+        }), BYTES);
+        
+        report("loadMap mapped" + SIZE, secondsPerRun(RUNS, [&]() {
+            map.loadMap(PATH, pxm::LOAD_MAPPED);
+            sink = map.getTiles().size();
+        }), BYTES);
+        
+        report("loadFromMemory" + SIZE, secondsPerRun(RUNS, [&]() {
+            map.loadFromMemory(FILE);
+            sink = map.getTiles().size();
+        }), BYTES);
+        
+        remove(PATH.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << std::fixed << std::setprecision(2);
+    
+    benchLoad(300, 240, 500); //about the size of the largest maps in the game
+    benchLoad(((argc > 2) ? strtoul(argv[1], nullptr, 10) : 4096), ((argc > 2) ? strtoul(argv[2], nullptr, 10) : 4096), 10);
+    
+    return 0;
+}
\ No newline at end of file
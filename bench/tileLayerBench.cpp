@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+
+#include <vector>
+
+#include <chrono>
+#include <random>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+/*
+ * Compares filling a tile layer one setTile() call at a time (how
+ * pxPack::readTileLayers() used to ingest tiles) against filling it
+ * with a single tileLayer::setTiles() block copy, on large synthetic
+ * layers.
+ */
+
+namespace {
+    typedef std::chrono::steady_clock benchClock;
+    
+    template <typename F>
+    double timePerRun(const int RUNS, F f) { //average time per run in milliseconds
+        const benchClock::time_point START = benchClock::now();
+        
+        for (int i = 0; i < RUNS; ++i) {
+            f();
+        }
+        
+        return std::chrono::duration <double, std::milli>(benchClock::now() - START).count() / RUNS;
+    }
+}
+
+int main() {
+    const uint16_t SIZES [][2] = {{400, 300}, {2000, 2000}, {8000, 8000}};
+    const int RUNS = 5;
+    
+    std::mt19937 rng(0);
+    
+    std::cout << std::fixed << std::setprecision(3);
+    
+    for (const auto& size : SIZES) {
+        const uint16_t WIDTH = size[0];
+        const uint16_t HEIGHT = size[1];
+        
+        std::vector <uint8_t> source((size_t)WIDTH * HEIGHT);
+        for (uint8_t& tile : source) {
+            tile = rng();
+        }
+        
+        fdl::keroBlaster::pxPack::tileLayer layer;
+        
+        const double PER_TILE_MS = timePerRun(RUNS, [&]() {
+            layer.reset();
+            layer.setDimensions(WIDTH, HEIGHT);
+            
+            for (int j = 0; j < HEIGHT; ++j) {
+                for (int k = 0; k < WIDTH; ++k) {
+                    layer.setTile(k, j, source[fdl::containerUtil::indexFromCoords(k, j, WIDTH)]);
+                }
+            }
+        });
+        
+        const double BLOCK_MS = timePerRun(RUNS, [&]() {
+            layer.reset();
+            layer.setTiles(WIDTH, HEIGHT, source.data());
+        });
+        
+        const double MEGABYTES = source.size() / (1024.0 * 1024.0);
+        
+        std::cout << WIDTH << 'x' << HEIGHT << ": setTile() " << PER_TILE_MS << " ms ("
+                  << MEGABYTES / (PER_TILE_MS / 1000) << " MB/s), setTiles() " << BLOCK_MS << " ms ("
+                  << MEGABYTES / (BLOCK_MS / 1000) << " MB/s), speedup " << PER_TILE_MS / BLOCK_MS << "x\n";
+    }
+    
+    return 0;
+}
\ No newline at end of file
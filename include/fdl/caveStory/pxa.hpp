@@ -0,0 +1,87 @@
+#ifndef PXA_HPP
+#define PXA_HPP
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        /**
+         * @brief The tile attributes of a Cave Story tileset (PXA file).
+         *
+         * A PXA file has no header: it's one attribute byte for each
+         * of the 256 tiles of a tileset, such as whether the tile is
+         * solid, a slope, water or spikes. Maps look up the attribute
+         * of each of their tiles here, and maps sharing a tileset share
+         * its attributes.
+         */
+        class pxa {
+            public:
+                static constexpr char FILE_EXTENSION [] = ".pxa";
+                
+                static constexpr size_t NUM_ATTRIBUTES = 256; /**< Number of tiles in a tileset, each with one attribute */
+                
+            private:
+                std::array <uint8_t, NUM_ATTRIBUTES> attributes;
+                
+            public:
+                pxa();
+                explicit pxa(const std::string& filename);
+                
+                const std::array <uint8_t, NUM_ATTRIBUTES>& getAttributes() const;
+                
+                uint8_t getAttribute(const uint8_t tile) const;
+                
+                /**
+                 * @brief Loads the PXA file at the given path.
+                 *
+                 * A file with fewer than NUM_ATTRIBUTES bytes causes the
+                 * object to reset its attributes to 0 and an
+                 * fdl::errorUtil::fileReadError exception to be thrown;
+                 * any bytes after the last attribute are ignored. Failing
+                 * to open the file throws an fdl::errorUtil::fileOpenError
+                 * exception. This is a wrapper around tryLoadFile(), which
+                 * returns errors instead.
+                 *
+                 * @param filename Path of the PXA file, including its extension.
+                 */
+                void loadFile(const std::string& filename);
+                
+                void loadFromMemory(const uint8_t* data, const size_t size);
+                void loadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * Loads the PXA file at the given path as loadFile() does,
+                 * but returns errors instead of throwing them. The file is
+                 * read into buffer, whose storage is reused, so loading many
+                 * files with the same buffer only allocates for the largest.
+                 */
+                fdl::errorUtil::result tryLoadFile(const std::string& filename, std::vector <uint8_t>& buffer);
+                
+                fdl::errorUtil::result tryLoadFromMemory(const uint8_t* data, const size_t size);
+                fdl::errorUtil::result tryLoadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * @return The message describing a failed result from loading
+                 *         the PXA file with the given name, as thrown by loadFile().
+                 */
+                static std::string getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename);
+                
+                /**
+                 * Sets every attribute to 0.
+                 */
+                void reset();
+                
+            private:
+                [[noreturn]] static void throwLoadError(const fdl::errorUtil::result& result, const std::string& filename);
+        };
+    }
+}
+
+#endif //PXA_HPP
\ No newline at end of file
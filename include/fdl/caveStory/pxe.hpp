@@ -0,0 +1,130 @@
+#ifndef PXE_HPP
+#define PXE_HPP
+
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/binaryReader.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        /**
+         * @brief The entities of a Cave Story map (PXE file).
+         *
+         * A PXE file is a 4-byte header, the number of entities as
+         * a little-endian 32-bit integer, and then 12 bytes for each
+         * entity. Entities are stored packed exactly as they are in
+         * the file, so they're read with a single copy.
+         */
+        class pxe {
+            private:
+                struct fileLayout;
+                
+            public:
+                static constexpr char FILE_EXTENSION [] = ".pxe";
+                
+                static constexpr char HEADER [] = {'P', 'X', 'E', '\0'}; /**< Header at the start of every PXE file */
+                static constexpr size_t HEAD_SIZE = sizeof(HEADER) + 4; /**< Size of the header and number of entities in bytes */
+                
+                static constexpr size_t ENTITY_SIZE = 12; /**< Size of an entity in a PXE file in bytes */
+                
+                /**
+                 * An entity as stored in a PXE file. Every field is a
+                 * 16-bit integer, so an entity has no padding and a
+                 * vector of them has the same layout as the file.
+                 */
+                struct entity {
+                    uint16_t x; /**< X coordinate in tiles */
+                    uint16_t y; /**< Y coordinate in tiles */
+                    uint16_t flagId; /**< Flag tested by the entity's flags, such as whether it appears */
+                    uint16_t event; /**< Event run when the entity is interacted with or dies */
+                    uint16_t type; /**< Which kind of NPC the entity is */
+                    uint16_t flags; /**< Bit flags adjusting the entity's behaviour */
+                };
+                
+            private:
+                std::vector <entity> entities;
+                
+            public:
+                pxe();
+                explicit pxe(const std::string& filename);
+                
+                const std::vector <entity>& getEntities() const;
+                
+                /**
+                 * @brief Loads the PXE file at the given path.
+                 *
+                 * Errors with parsing the file will cause the object to
+                 * completely reset its state to avoid data corruption and
+                 * an fdl::errorUtil::fileReadError exception to be thrown.
+                 * Failing to open the file throws an fdl::errorUtil::fileOpenError
+                 * exception. This is a wrapper around tryLoadFile(), which
+                 * returns errors instead.
+                 *
+                 * @param filename Path of the PXE file, including its extension.
+                 */
+                void loadFile(const std::string& filename);
+                
+                /**
+                 * Parses a PXE file that's already in memory, as loadFile()
+                 * does. The entities are copied, so the buffer can be freed
+                 * afterwards.
+                 *
+                 * @param data Pointer to the first byte of the PXE file.
+                 * @param size Size of the PXE file in bytes.
+                 */
+                void loadFromMemory(const uint8_t* data, const size_t size);
+                void loadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * Loads the PXE file at the given path as loadFile() does,
+                 * but returns errors instead of throwing them. The file is
+                 * read into buffer, whose storage is reused, so loading many
+                 * files with the same buffer only allocates for the largest.
+                 *
+                 * @return The result of loading the file, whose error (if any)
+                 *         carries the byte offset at which it was found and
+                 *         the index of the entity being parsed.
+                 */
+                fdl::errorUtil::result tryLoadFile(const std::string& filename, std::vector <uint8_t>& buffer);
+                
+                fdl::errorUtil::result tryLoadFromMemory(const uint8_t* data, const size_t size);
+                fdl::errorUtil::result tryLoadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * @return The message describing a failed result from loading
+                 *         the PXE file with the given name, as thrown by loadFile().
+                 */
+                static std::string getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename);
+                
+                /**
+                 * @return The size of the entities' PXE file in bytes.
+                 */
+                size_t getFileSize() const;
+                
+                /**
+                 * Writes the entities as a PXE file to buffer, which
+                 * must have room for getFileSize() bytes.
+                 */
+                void saveToBuffer(uint8_t* buffer) const;
+                std::vector <uint8_t> saveToBuffer() const;
+                
+                /**
+                 * Removes every entity.
+                 */
+                void reset();
+                
+            private:
+                fdl::errorUtil::result parse(fdl::fileUtil::binaryReader& file);
+                
+                [[noreturn]] static void throwLoadError(const fdl::errorUtil::result& result, const std::string& filename);
+        };
+    }
+}
+
+#endif //PXE_HPP
\ No newline at end of file
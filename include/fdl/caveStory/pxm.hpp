@@ -1,20 +1,161 @@
 #ifndef PXM_HPP
 #define PXM_HPP
 
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/containerUtil/tileGrid.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/binaryReader.hpp"
+
 namespace fdl {
     namespace caveStory {
+        /**
+         * @brief A Cave Story map (PXM file).
+         *
+         * A PXM file is a 4-byte header, the map's width and height
+         * as little-endian 16-bit integers, and then one byte per
+         * tile, row by row. The tiles are always read as one block,
+         * never tile by tile. A pxm is a tile grid, so the algorithms
+         * in fdl/containerUtil/tileGrid.hpp work on it.
+         */
         class pxm {
+            friend struct fdl::containerUtil::tileGridTraits <pxm>;
+            
             private:
+                struct fileLayout;
+                
                 uint16_t width;
                 uint16_t height;
                 
                 std::vector <uint8_t> tiles;
                 
             public:
+                static constexpr char FILE_EXTENSION [] = ".pxm";
+                
+                static constexpr char HEADER [] = {'P', 'X', 'M', 0x10}; /**< Header at the start of every PXM file (not null-terminated) */
+                static constexpr size_t HEAD_SIZE = sizeof(HEADER) + 4; /**< Size of the header and dimensions in bytes */
+                
+                /**
+                 * Ways in which loadMap() can read a PXM file.
+                 */
+                enum loadMode {
+                    LOAD_STREAM, /**< Read the file through an std::ifstream, reading the tiles with a single call */
+                    LOAD_MAPPED /**< Map the file into memory and copy the tiles from the mapping */
+                };
+                
                 pxm();
-                pxm(const std::string& filename);
+                explicit pxm(const std::string& filename, const loadMode mode = LOAD_STREAM);
+                
+                uint16_t getWidth() const;
+                uint16_t getHeight() const;
+                const std::vector <uint8_t>& getTiles() const;
+                
+                /**
+                 * Returns the tile at the given coordinates. An
+                 * std::out_of_range exception is thrown if the
+                 * coordinates are outside the map.
+                 */
+                uint8_t getTile(const uint16_t x, const uint16_t y) const;
+                
+                /**
+                 * @brief Loads the PXM file at the given path.
+                 *
+                 * Errors with parsing the file will cause the object to
+                 * completely reset its state to avoid data corruption and
+                 * an fdl::errorUtil::fileReadError exception to be thrown.
+                 * Failing to open the file throws an fdl::errorUtil::fileOpenError
+                 * exception. This is a wrapper around tryLoadMap(), which
+                 * returns errors instead.
+                 *
+                 * @param filename Path of the PXM file, including its extension.
+                 * @param mode How the file is read.
+                 */
+                void loadMap(const std::string& filename, const loadMode mode = LOAD_STREAM);
                 
-                void loadMap(const std::string& filename);
+                /**
+                 * Parses a PXM file that's already in memory, as loadMap()
+                 * does. The tiles are copied, so the buffer can be freed
+                 * afterwards.
+                 *
+                 * @param data Pointer to the first byte of the PXM file.
+                 * @param size Size of the PXM file in bytes.
+                 */
+                void loadFromMemory(const uint8_t* data, const size_t size);
+                void loadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * Loads the PXM file at the given path as loadMap() does,
+                 * but returns errors instead of throwing them.
+                 *
+                 * @return The result of loading the file, whose error (if any)
+                 *         carries the byte offset at which it was found.
+                 *         getLoadErrorMessage() turns it into the message
+                 *         loadMap() would have thrown.
+                 */
+                fdl::errorUtil::result tryLoadMap(const std::string& filename, const loadMode mode = LOAD_STREAM);
+                
+                fdl::errorUtil::result tryLoadFromMemory(const uint8_t* data, const size_t size);
+                fdl::errorUtil::result tryLoadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * @return The message describing a failed result from loading
+                 *         the PXM file with the given name, as thrown by loadMap().
+                 */
+                static std::string getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename);
+                
+                /**
+                 * @return The size of the map's PXM file in bytes.
+                 */
+                size_t getFileSize() const;
+                
+                /**
+                 * Writes the map as a PXM file to buffer, which must
+                 * have room for getFileSize() bytes.
+                 */
+                void saveToBuffer(uint8_t* buffer) const;
+                std::vector <uint8_t> saveToBuffer() const;
+                
+                /**
+                 * Clears the map's dimensions and tiles.
+                 */
+                void reset();
+                
+            private:
+                fdl::errorUtil::result readHead(fdl::fileUtil::binaryReader& file);
+                fdl::errorUtil::result parse(fdl::fileUtil::binaryReader& file);
+                
+                [[noreturn]] static void throwLoadError(const fdl::errorUtil::result& result, const std::string& filename);
+        };
+    }
+    
+    namespace containerUtil {
+        template <>
+        struct tileGridTraits <fdl::caveStory::pxm> {
+            static size_t getWidth(const fdl::caveStory::pxm& map) {
+                return map.width;
+            }
+            
+            static size_t getHeight(const fdl::caveStory::pxm& map) {
+                return map.height;
+            }
+            
+            static const uint8_t* getTiles(const fdl::caveStory::pxm& map) {
+                return map.tiles.data();
+            }
+            
+            static uint8_t* getWritableTiles(fdl::caveStory::pxm& map) {
+                return map.tiles.data();
+            }
+            
+            static const char* getName() {
+                return "PXM map";
+            }
         };
     }
 }
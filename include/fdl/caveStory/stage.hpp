@@ -0,0 +1,89 @@
+#ifndef STAGE_HPP
+#define STAGE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <cstdint>
+
+#include "fdl/caveStory/pxm.hpp"
+#include "fdl/caveStory/pxe.hpp"
+#include "fdl/caveStory/pxa.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        /**
+         * Names the files of a stage: its map and entities are
+         * named after the stage, and its tile attributes after
+         * its tileset.
+         */
+        struct stageInfo {
+            std::string name; /**< Name of the stage's PXM and PXE files, without their extensions */
+            std::string tilesetName; /**< Name of the tileset's PXA file, without its extension */
+        };
+        
+        /**
+         * @brief A loaded Cave Story stage.
+         *
+         * Stages with the same tileset share one copy of its
+         * attributes.
+         */
+        struct stage {
+            std::string name;
+            std::string tilesetName;
+            
+            pxm map;
+            pxe entities;
+            std::shared_ptr <const pxa> attributes;
+        };
+        
+        /**
+         * Describes a stage file that failed to load
+         * as part of a batch.
+         */
+        struct stageLoadError {
+            std::string filename; /**< Path of the file that failed to load */
+            std::string message; /**< Message describing the error, as the file's class would have thrown it */
+            fdl::errorUtil::errorCode code; /**< What went wrong with the file */
+            uint64_t offset; /**< Byte offset in the file at which the error was found */
+        };
+        
+        /**
+         * @brief The outcome of loading a batch of stages.
+         *
+         * Stages are stored in the order they were given, with
+         * any that had a file fail to load left out. Each file
+         * that failed is recorded in errors once, even if it's
+         * a PXA file shared by several stages.
+         */
+        struct stageBatch {
+            std::vector <stage> stages;
+            std::vector <stageLoadError> errors;
+        };
+        
+        /**
+         * @brief Loads the PXM, PXE and PXA files of many stages concurrently.
+         *
+         * Every file of every stage is a separate job for a pool of
+         * worker threads, so the reads of a stage's three files overlap
+         * rather than following one another. Each PXA file is read
+         * only once however many stages use it. Workers reuse one
+         * buffer each for reading files, and errors are returned
+         * rather than thrown, so a batch of stages costs little more
+         * than reading its files.
+         *
+         * @param folder Folder holding the stage files (such as data/Stage).
+         * @param stages The stages to load.
+         * @param maxThreads Most worker threads to use, or 0 to use
+         *                   one per hardware thread.
+         *
+         * @return The loaded stages and the errors of the files that failed.
+         */
+        stageBatch loadStages(const std::string& folder, const std::vector <stageInfo>& stages, unsigned int maxThreads = 0);
+    }
+}
+
+#endif //STAGE_HPP
\ No newline at end of file
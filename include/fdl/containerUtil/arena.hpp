@@ -0,0 +1,83 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <memory>
+
+#include <cstddef>
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /**
+         * @brief A monotonic memory arena.
+         *
+         * Class that hands out memory from a few large blocks
+         * by bumping a pointer, so many allocations cost a
+         * handful of calls to operator new and freeing them all
+         * is just freeing the blocks when the arena is destroyed.
+         * Deallocated memory is only reclaimed if it was the most
+         * recent allocation; otherwise it stays unused until the
+         * arena is destroyed. Arenas aren't thread-safe.
+         */
+        class arena {
+            public:
+                static constexpr size_t DEFAULT_BLOCK_SIZE = 4096; /**< Size in bytes of an arena's first block unless told otherwise */
+                
+            private:
+                std::vector <std::unique_ptr <unsigned char []>> blocks;
+                
+                unsigned char* next; //first free byte in the current block
+                size_t remaining; //free bytes left in the current block
+                size_t lastBlockSize;
+                
+                size_t capacity;
+                size_t usage;
+                
+                //the most recent allocation, which can be handed back
+                void* lastAllocation;
+                size_t lastAllocationSize;
+                
+            public:
+                /**
+                 * Creates an arena whose first block holds the given
+                 * number of bytes. Each later block is at least twice
+                 * as large as the one before it. If initialSize is 0,
+                 * no block is allocated until the first allocation.
+                 */
+                explicit arena(const size_t initialSize = DEFAULT_BLOCK_SIZE);
+                
+                arena(const arena&) = delete;
+                arena& operator=(const arena&) = delete;
+                
+                /**
+                 * @return Pointer to size bytes aligned to alignment,
+                 *         which must be a power of two no greater than
+                 *         alignof(std::max_align_t).
+                 */
+                void* allocate(const size_t size, const size_t alignment);
+                
+                /**
+                 * Returns memory to the arena. Only the most
+                 * recent allocation can be reused.
+                 */
+                void deallocate(void* pointer, const size_t size);
+                
+                /**
+                 * @return Total size in bytes of the arena's blocks.
+                 */
+                size_t getCapacity() const;
+                
+                /**
+                 * @return Bytes handed out and not reclaimed, including
+                 *         padding for alignment.
+                 */
+                size_t getUsage() const;
+                
+            private:
+                void addBlock(const size_t minSize);
+        };
+    }
+}
+
+#endif //ARENA_HPP
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef ARENAALLOCATOR_HPP
+#define ARENAALLOCATOR_HPP
+
+#include <string>
+#include <memory>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+#include "fdl/containerUtil/arena.hpp"
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /**
+         * @brief An allocator that draws from a shared arena, with a size limit.
+         *
+         * Class that allocates a container's storage from an arena
+         * which it shares ownership of, so every container belonging
+         * to one object (a map, for instance) can live in the same few
+         * blocks and be freed together. Like limitedAllocator, it also
+         * limits how many elements a container can hold. Without an
+         * arena, it allocates from the heap as std::allocator does.
+         *
+         * Copying a container gives the copy its own arena, since
+         * arenas aren't thread-safe; moving or swapping containers
+         * moves their arenas along with their storage.
+         */
+        template <typename T>
+        class arenaAllocator {
+            template <typename U>
+            friend class arenaAllocator;
+            
+            public:
+                typedef T value_type;
+                typedef size_t size_type;
+                typedef ptrdiff_t difference_type;
+                
+                typedef std::false_type propagate_on_container_copy_assignment;
+                typedef std::true_type propagate_on_container_move_assignment;
+                typedef std::true_type propagate_on_container_swap;
+                
+                template <typename U>
+                struct rebind {
+                    typedef arenaAllocator <U> other;
+                };
+                
+            private:
+                std::shared_ptr <arena> source;
+                size_type maxSize;
+                
+            public:
+                /**
+                 * @param source Arena to allocate from, or nullptr to
+                 *               allocate from the heap.
+                 * @param maxSize Most elements a container using
+                 *                this allocator can hold.
+                 */
+                explicit arenaAllocator(std::shared_ptr <arena> source = nullptr,
+                                        const size_type maxSize = std::numeric_limits <size_type>::max() / sizeof(T)) :
+                                        source(std::move(source)), maxSize(maxSize) {}
+                
+                template <typename U>
+                arenaAllocator(const arenaAllocator <U>& other) : source(other.source), maxSize(other.maxSize) {}
+                
+                T* allocate(const size_type count) {
+                    if (count > max_size()) {
+                        throw std::length_error("ERROR: Attempt to allocate more than " + std::to_string(max_size()) +
+                                                " elements from a limited allocator.");
+                    }
+                    
+                    if (source) {
+                        return static_cast <T*>(source -> allocate(count * sizeof(T), alignof(T)));
+                    }
+                    
+                    return static_cast <T*>(::operator new(count * sizeof(T)));
+                }
+                
+                void deallocate(T* pointer, const size_type count) {
+                    if (source) {
+                        source -> deallocate(pointer, count * sizeof(T));
+                    }
+                    else {
+                        ::operator delete(pointer);
+                    }
+                }
+                
+                /**
+                 * Default-initializes elements that are trivial to
+                 * construct instead of zeroing them, so resize() doesn't
+                 * write a buffer that's about to be copied over. Code
+                 * that needs the new elements zeroed has to clear them.
+                 */
+                template <typename U>
+                typename std::enable_if <std::is_trivially_default_constructible <U>::value>::type construct(U* pointer) {
+                    ::new(static_cast <void*>(pointer)) U;
+                }
+                
+                template <typename U, typename... Args>
+                void construct(U* pointer, Args&&... args) {
+                    ::new(static_cast <void*>(pointer)) U(std::forward <Args>(args)...);
+                }
+                
+                size_type max_size() const {
+                    return maxSize;
+                }
+                
+                /**
+                 * @return The arena allocated from, or nullptr if
+                 *         allocating from the heap.
+                 */
+                const std::shared_ptr <arena>& getArena() const {
+                    return source;
+                }
+                
+                /**
+                 * Gives copies of containers a fresh arena of their own,
+                 * which doesn't allocate a block until the copy needs one.
+                 */
+                arenaAllocator select_on_container_copy_construction() const {
+                    return arenaAllocator((source ? std::make_shared <arena>(0) : nullptr), maxSize);
+                }
+                
+                template <typename U>
+                bool operator==(const arenaAllocator <U>& other) const {
+                    return source == other.source;
+                }
+                
+                template <typename U>
+                bool operator!=(const arenaAllocator <U>& other) const {
+                    return source != other.source;
+                }
+        };
+    }
+}
+
+#endif //ARENAALLOCATOR_HPP
\ No newline at end of file
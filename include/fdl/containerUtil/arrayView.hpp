@@ -0,0 +1,77 @@
+#ifndef ARRAYVIEW_HPP
+#define ARRAYVIEW_HPP
+
+#include <string>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /**
+         * @brief A non-owning view of a contiguous array.
+         *
+         * Class that refers to a run of elements owned by
+         * something else (a vector, a mapped file, etc.) so
+         * they can be read without copying them. A view is
+         * only valid for as long as the storage it points to
+         * isn't freed or reallocated.
+         */
+        template <typename T>
+        class arrayView {
+            public:
+                typedef T value_type;
+                typedef T* iterator;
+                typedef size_t size_type;
+                
+            private:
+                T* first;
+                size_type length;
+                
+            public:
+                arrayView() : first(nullptr), length(0) {}
+                arrayView(T* first, const size_type length) : first(first), length(length) {}
+                
+                T* data() const {
+                    return first;
+                }
+                
+                size_type size() const {
+                    return length;
+                }
+                
+                bool empty() const {
+                    return (0 == length);
+                }
+                
+                iterator begin() const {
+                    return first;
+                }
+                
+                iterator end() const {
+                    return first + length;
+                }
+                
+                T& operator[](const size_type index) const {
+                    return first[index];
+                }
+                
+                /**
+                 * Bounds-checked element access. An std::out_of_range
+                 * exception is thrown if index is past the end of the view.
+                 */
+                T& at(const size_type index) const {
+                    if (index >= length) {
+                        throw std::out_of_range("ERROR: Attempt to access index " + std::to_string(index) +
+                                                " of a view of size " + std::to_string(length) + '.');
+                    }
+                    
+                    return first[index];
+                }
+        };
+    }
+}
+
+#endif //ARRAYVIEW_HPP
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef BYTEKERNELS_HPP
+#define BYTEKERNELS_HPP
+
+#include <array>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /*
+         * Bulk operations over arrays of bytes. Where the CPU supports
+         * them, they use AVX2 or SSE2, chosen at runtime the first time
+         * any of them is called; otherwise they fall back to plain loops.
+         */
+        
+        /**
+         * Replaces every occurrence of one byte in an array with another.
+         *
+         * @param data The bytes to search.
+         * @param size The number of bytes in data.
+         * @param from The byte to replace.
+         * @param to The byte to replace it with.
+         *
+         * @return The number of bytes replaced.
+         */
+        size_t replaceBytes(uint8_t* data, const size_t size, const uint8_t from, const uint8_t to);
+        
+        /**
+         * @return The number of positions at which two arrays of
+         *         size bytes each hold different bytes.
+         */
+        size_t countDifferentBytes(const uint8_t* a, const uint8_t* b, const size_t size);
+        
+        /**
+         * Adds the number of times each byte value appears in
+         * an array to the given histogram.
+         *
+         * @param data The bytes to count.
+         * @param size The number of bytes in data.
+         * @param histogram Counts indexed by byte value, which
+         *                  are added to rather than overwritten.
+         */
+        void countBytes(const uint8_t* data, const size_t size, std::array <size_t, 256>& histogram);
+        
+        /**
+         * Copies an array of bytes, passing each one through a
+         * lookup table. source and destination may be the same
+         * array but mustn't otherwise overlap.
+         *
+         * @param destination Where the remapped bytes are written.
+         * @param source The bytes to remap.
+         * @param size The number of bytes in source.
+         * @param table The byte that each byte value is replaced with.
+         */
+        void remapBytes(uint8_t* destination, const uint8_t* source, const size_t size,
+                        const std::array <uint8_t, 256>& table);
+        
+        /**
+         * @brief Copies RGBA pixels, skipping transparent ones.
+         *
+         * Copies each 4-byte RGBA pixel of source over the pixel at
+         * the same position in destination unless its alpha is 0.
+         * Alpha is treated as a mask, as pixel art uses it, so any
+         * other alpha copies the pixel as it is. The arrays mustn't
+         * overlap.
+         *
+         * @param destination The pixels to draw over.
+         * @param source The pixels to draw.
+         * @param numPixels The number of pixels (not bytes) in source.
+         */
+        void blitPixels(uint8_t* destination, const uint8_t* source, const size_t numPixels);
+        
+        /**
+         * @return The name of the instruction set the bulk byte
+         *         operations use on this CPU ("avx2", "sse2" or
+         *         "scalar").
+         */
+        const char* getByteKernelTarget();
+    }
+}
+
+#endif //BYTEKERNELS_HPP
\ No newline at end of file
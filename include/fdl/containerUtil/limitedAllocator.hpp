@@ -17,6 +17,9 @@ namespace fdl {
          */
         template <typename T>
         class limitedAllocator : public std::allocator <T> {
+            template <typename U>
+            friend class limitedAllocator;
+            
             public:
                 template <typename U> 
                 struct rebind {
@@ -25,9 +28,14 @@ namespace fdl {
                 
                 typedef typename std::allocator<T>::size_type size_type;
                 
-                limitedAllocator(size_type size);
+                limitedAllocator(size_type maxSize) : maxSize(maxSize) {}
                 
-                size_type max_size() const;
+                template <typename U>
+                limitedAllocator(const limitedAllocator <U>& other) : maxSize(other.maxSize) {}
+                
+                size_type max_size() const {
+                    return maxSize;
+                }
                 
             private:
                 size_type maxSize;
@@ -36,6 +44,4 @@ namespace fdl {
     }
 }
 
-#include "limitedAllocator.cpp"
-
 #endif //LIMITEDALLOCATOR_HPP
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <string>
+#include <array>
+#include <unordered_map>
+#include <memory>
+
+#include <mutex>
+#include <atomic>
+
+#include <cstdint>
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /**
+         * @brief A table of interned strings.
+         *
+         * Class that stores one copy of each distinct string given
+         * to it and hands out a small integer handle for each, so
+         * that objects repeating the same few strings can store and
+         * compare handles instead. Equal strings in the same pool
+         * always get the same handle. Strings are never removed, and
+         * references returned by get() stay valid for as long as the
+         * pool exists, so a pool is best shared by a group of objects
+         * that are freed together. All methods may be called from any
+         * number of threads at once.
+         */
+        class stringPool {
+            public:
+                typedef uint32_t handle;
+                
+                static constexpr handle EMPTY = 0; /**< Handle of the empty string, which every pool holds */
+                
+                static constexpr size_t CHUNK_SIZE = 1024; /**< Number of strings per block of the handle table */
+                static constexpr size_t MAX_NUM_CHUNKS = 4096;
+                static constexpr size_t MAX_NUM_STRINGS = CHUNK_SIZE * MAX_NUM_CHUNKS; /**< Most strings a pool can hold */
+                
+            private:
+                mutable std::mutex mutex;
+                
+                //keys of a node-based map never move, so the table can point straight at them
+                std::unordered_map <std::string, handle> index;
+                
+                //handle table, split into chunks that are never reallocated so get() needn't lock
+                std::array <std::unique_ptr <const std::string* []>, MAX_NUM_CHUNKS> chunks;
+                std::atomic <size_t> count;
+                
+            public:
+                /**
+                 * Creates a pool holding only the empty string.
+                 */
+                stringPool();
+                
+                stringPool(const stringPool&) = delete;
+                stringPool& operator=(const stringPool&) = delete;
+                
+                /**
+                 * Adds the given string to the pool if it isn't
+                 * there already. An std::length_error exception is
+                 * thrown if the pool already holds MAX_NUM_STRINGS
+                 * strings.
+                 *
+                 * @return The string's handle.
+                 */
+                handle intern(const std::string& str);
+                
+                /**
+                 * Adds the given string to the pool as intern() does,
+                 * but fails instead of throwing if the pool is full.
+                 *
+                 * @param id Set to the string's handle if it's interned.
+                 *
+                 * @return Whether the string is in the pool.
+                 */
+                bool tryIntern(const std::string& str, handle& id);
+                
+                /**
+                 * Looks up a string without adding it to the pool.
+                 *
+                 * @param id Set to the string's handle if it's found.
+                 *
+                 * @return Whether the pool holds the string.
+                 */
+                bool find(const std::string& str, handle& id) const;
+                
+                /**
+                 * Returns the string with the given handle. An
+                 * std::out_of_range exception is thrown if the
+                 * handle didn't come from this pool.
+                 */
+                const std::string& get(const handle id) const;
+                
+                /**
+                 * @return The number of strings in the pool.
+                 */
+                size_t size() const;
+        };
+    }
+}
+
+#endif //STRINGPOOL_HPP
\ No newline at end of file
@@ -0,0 +1,238 @@
+#ifndef TILEGRID_HPP
+#define TILEGRID_HPP
+
+#include <string>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include <stdexcept>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memset(void* dest, int ch, size_t count)
+
+#include "fdl/containerUtil/containerUtil.hpp"
+#include "fdl/containerUtil/byteKernels.hpp"
+
+namespace fdl {
+    namespace containerUtil {
+        
+        /**
+         * @brief Describes how to reach the tiles of a tile grid type.
+         *
+         * A tile grid is anything holding width * height one-byte
+         * tiles stored row by row, such as a Cave Story map or a
+         * PXPACK tile layer. Specializing this for a type lets every
+         * tile grid algorithm below work on it; each algorithm is
+         * compiled separately for each grid type, so nothing is
+         * dispatched at runtime. A specialization provides:
+         *
+         * - static size_t getWidth(const Grid&)
+         * - static size_t getHeight(const Grid&)
+         * - static const uint8_t* getTiles(const Grid&)
+         * - static uint8_t* getWritableTiles(Grid&), which may prepare
+         *   the tiles for writing first (such as by copying mapped ones)
+         * - static const char* getName(), naming the type in error messages
+         *
+         * and optionally:
+         *
+         * - static void tilesWritten(Grid&, size_t firstRow, size_t endRow),
+         *   called by the algorithms below once they've written to rows
+         *   [firstRow, endRow), so grids can update anything derived
+         *   from their tiles
+         *
+         * Specializations live next to the grid types they describe.
+         */
+        template <typename Grid>
+        struct tileGridTraits {};
+        
+        namespace detail {
+            template <typename Grid, typename = void>
+            struct isTileGrid : std::false_type {};
+            
+            template <typename Grid>
+            struct isTileGrid <Grid, decltype((void)tileGridTraits <Grid>::getWidth(std::declval <const Grid&>()),
+                                              (void)tileGridTraits <Grid>::getHeight(std::declval <const Grid&>()),
+                                              (void)tileGridTraits <Grid>::getTiles(std::declval <const Grid&>()),
+                                              (void)tileGridTraits <Grid>::getWritableTiles(std::declval <Grid&>()),
+                                              (void)tileGridTraits <Grid>::getName())> : std::true_type {};
+            
+            //calls tileGridTraits <Grid>::tilesWritten() if the grid has one; the int argument prefers this overload
+            template <typename Grid>
+            auto tilesWritten(Grid& grid, const size_t firstRow, const size_t endRow, int)
+                -> decltype(tileGridTraits <Grid>::tilesWritten(grid, firstRow, endRow)) {
+                return tileGridTraits <Grid>::tilesWritten(grid, firstRow, endRow);
+            }
+            
+            template <typename Grid>
+            void tilesWritten(Grid&, const size_t, const size_t, long) {}
+            
+            template <typename Grid>
+            std::string describeGrid(const Grid& grid) {
+                return std::to_string(tileGridTraits <Grid>::getWidth(grid)) + 'x' +
+                       std::to_string(tileGridTraits <Grid>::getHeight(grid)) + ' ' + tileGridTraits <Grid>::getName();
+            }
+        }
+        
+        /**
+         * True if Grid has a complete tileGridTraits specialization.
+         */
+        template <typename Grid>
+        struct isTileGrid : detail::isTileGrid <typename std::remove_cv <Grid>::type> {};
+        
+        template <typename Grid>
+        size_t getNumTiles(const Grid& grid) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            return tileGridTraits <Grid>::getWidth(grid) * tileGridTraits <Grid>::getHeight(grid);
+        }
+        
+        /**
+         * Calls f(y, row) for each row of the grid in order, where row
+         * points to the row's getWidth() tiles. This is the fastest way
+         * to visit every tile, since each row is contiguous.
+         */
+        template <typename Grid, typename F>
+        void forEachRow(const Grid& grid, F f) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            const size_t WIDTH = tileGridTraits <Grid>::getWidth(grid);
+            const size_t HEIGHT = tileGridTraits <Grid>::getHeight(grid);
+            const uint8_t* const TILES = tileGridTraits <Grid>::getTiles(grid);
+            
+            for (size_t y = 0; y < HEIGHT; ++y) {
+                f(y, TILES + indexFromCoords(0, y, WIDTH));
+            }
+        }
+        
+        /**
+         * Sets every tile in the grid.
+         */
+        template <typename Grid>
+        void fill(Grid& grid, const uint8_t tile) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            const size_t NUM_TILES = getNumTiles(grid);
+            
+            if (NUM_TILES > 0) {
+                memset(tileGridTraits <Grid>::getWritableTiles(grid), tile, NUM_TILES);
+                detail::tilesWritten(grid, 0, tileGridTraits <Grid>::getHeight(grid), 0);
+            }
+        }
+        
+        /**
+         * Sets every tile in a rectangle of the grid. An
+         * std::out_of_range exception is thrown if the
+         * rectangle extends outside the grid.
+         *
+         * @param grid The grid to fill.
+         * @param x Left edge of the rectangle.
+         * @param y Top edge of the rectangle.
+         * @param width Width of the rectangle.
+         * @param height Height of the rectangle.
+         * @param tile The tile to fill the rectangle with.
+         */
+        template <typename Grid>
+        void fillRect(Grid& grid, const size_t x, const size_t y, const size_t width, const size_t height, const uint8_t tile) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            const size_t GRID_WIDTH = tileGridTraits <Grid>::getWidth(grid);
+            
+            if (x + width > GRID_WIDTH || y + height > tileGridTraits <Grid>::getHeight(grid)) {
+                throw std::out_of_range("ERROR: Attempt to fill " + std::to_string(width) + 'x' + std::to_string(height) +
+                                        " rectangle at (" + std::to_string(x) + ", " + std::to_string(y) + ") of a " +
+                                        detail::describeGrid(grid) + '.');
+            }
+            
+            if (0 == width || 0 == height) {
+                return;
+            }
+            
+            uint8_t* const TILES = tileGridTraits <Grid>::getWritableTiles(grid);
+            
+            //rows of the rectangle aren't contiguous, but each one is a single memset
+            for (size_t i = y; i < y + height; ++i) {
+                memset(TILES + indexFromCoords(x, i, GRID_WIDTH), tile, width);
+            }
+            
+            detail::tilesWritten(grid, y, y + height, 0);
+        }
+        
+        /**
+         * Replaces every occurrence of one tile in the grid with another.
+         *
+         * @return The number of tiles replaced.
+         */
+        template <typename Grid>
+        size_t replaceTile(Grid& grid, const uint8_t from, const uint8_t to) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            const size_t NUM_TILES = getNumTiles(grid);
+            const size_t REPLACED = ((NUM_TILES > 0) ? replaceBytes(tileGridTraits <Grid>::getWritableTiles(grid), NUM_TILES, from, to) : 0);
+            
+            if (REPLACED > 0) {
+                detail::tilesWritten(grid, 0, tileGridTraits <Grid>::getHeight(grid), 0);
+            }
+            
+            return REPLACED;
+        }
+        
+        /**
+         * @return The number of times each tile appears in
+         *         the grid, indexed by tile value.
+         */
+        template <typename Grid>
+        std::array <size_t, 256> getHistogram(const Grid& grid) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            std::array <size_t, 256> histogram = {};
+            countBytes(tileGridTraits <Grid>::getTiles(grid), getNumTiles(grid), histogram);
+            
+            return histogram;
+        }
+        
+        /**
+         * Counts the tiles that differ between two grids, which may be
+         * of different types. An std::invalid_argument exception is
+         * thrown if the grids' dimensions differ.
+         *
+         * @return The number of coordinates at which the
+         *         grids hold different tiles.
+         */
+        template <typename GridA, typename GridB>
+        size_t countDifferences(const GridA& a, const GridB& b) {
+            static_assert(isTileGrid <GridA>::value && isTileGrid <GridB>::value,
+                          "Both grids must specialize fdl::containerUtil::tileGridTraits");
+            
+            if (tileGridTraits <GridA>::getWidth(a) != tileGridTraits <GridB>::getWidth(b) ||
+                tileGridTraits <GridA>::getHeight(a) != tileGridTraits <GridB>::getHeight(b)) {
+                throw std::invalid_argument("ERROR: Attempt to compare a " + detail::describeGrid(a) + " with a " +
+                                            detail::describeGrid(b) + '.');
+            }
+            
+            return countDifferentBytes(tileGridTraits <GridA>::getTiles(a), tileGridTraits <GridB>::getTiles(b), getNumTiles(a));
+        }
+        
+        /**
+         * Replaces each tile in the grid with table[tile].
+         *
+         * @param grid The grid to remap.
+         * @param table The tile that each tile value is replaced with.
+         */
+        template <typename Grid>
+        void remapTiles(Grid& grid, const std::array <uint8_t, 256>& table) {
+            static_assert(isTileGrid <Grid>::value, "Grid must specialize fdl::containerUtil::tileGridTraits");
+            
+            const size_t NUM_TILES = getNumTiles(grid);
+            
+            if (NUM_TILES > 0) {
+                uint8_t* const TILES = tileGridTraits <Grid>::getWritableTiles(grid);
+                remapBytes(TILES, TILES, NUM_TILES, table);
+                detail::tilesWritten(grid, 0, tileGridTraits <Grid>::getHeight(grid), 0);
+            }
+        }
+    }
+}
+
+#endif //TILEGRID_HPP
\ No newline at end of file
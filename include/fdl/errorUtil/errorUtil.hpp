@@ -1,19 +1,98 @@
 #ifndef ERRORUTIL_HPP
 #define ERRORUTIL_HPP
 
+#include <string>
+
+#include <cstdint>
+
 namespace fdl {
     namespace errorUtil {
         enum errorCode {
+            SUCCESS,
             FILE_OPENFAIL,
+            FILE_READFAIL,
+            FILE_BADHEADER, /**< The header at the start of the file is incorrect */
+            FILE_BADHEAD, /**< The file ends partway through its head */
+            FILE_BADLAYERHEADER, /**< The header at the start of a tile layer is incorrect */
+            FILE_BADLAYER, /**< The file ends partway through a tile layer */
+            FILE_BADENTITYCOUNT, /**< The file ends partway through its number of entities */
+            FILE_BADENTITY, /**< The file ends partway through an entity */
+            FILE_BADENTITYNAME, /**< An entity's name is too long */
+            FILE_BADATTRIBUTES, /**< The file ends partway through its tile attributes */
+            FILE_NAMEPOOLFULL, /**< The string pool given to hold the file's asset names is full */
             NUM_ERROR_CODES
         };
         
-        std::string errorStrings[NUM_ERROR_CODES] = {"ERROR: Failed to open file "};
+        //constexpr (and so internal to each translation unit) so that defining it in a header is fine
+        constexpr const char* ERROR_STRINGS [NUM_ERROR_CODES] = {"No error in file ",
+                                                                 "ERROR: Failed to open file ",
+                                                                 "ERROR: Failed to read file ",
+                                                                 "ERROR: Incorrect header in file ",
+                                                                 "ERROR: Could not parse head of file ",
+                                                                 "ERROR: Incorrect layer header in file ",
+                                                                 "ERROR: Could not parse tile layer of file ",
+                                                                 "ERROR: Could not parse entity number of file ",
+                                                                 "ERROR: Could not parse entity of file ",
+                                                                 "ERROR: Entity name is too long in file ",
+                                                                 "ERROR: Could not parse tile attributes of file ",
+                                                                 "ERROR: String pool is too full to hold the asset names of file "};
         
-        std::string getErrorString(const errorCode errCode) { //TODO: Make this constexpr (need C strings)
-            return errorStrings[errCode];
+        constexpr const char* getErrorString(const errorCode errCode) {
+            return ERROR_STRINGS[errCode];
         }
         
+        /**
+         * @brief The outcome of an operation that returns errors instead of throwing them.
+         *
+         * Like an expected object that holds nothing on success: it
+         * holds either SUCCESS or an error code along with the byte
+         * offset in the file at which the error was found and the
+         * index of the item (tile layer, entity, etc.) being read,
+         * if there was one. It never allocates, so failing is no
+         * more expensive than succeeding.
+         */
+        class result {
+            private:
+                errorCode code;
+                uint64_t offset;
+                uint32_t index;
+                
+            public:
+                constexpr result() : code(SUCCESS), offset(0), index(0) {}
+                constexpr result(const errorCode code, const uint64_t offset, const uint32_t index = 0) : code(code), offset(offset),
+                                                                                                      index(index) {}
+                
+                /**
+                 * @return True if the operation succeeded, false otherwise.
+                 */
+                constexpr bool ok() const {
+                    return (SUCCESS == code);
+                }
+                
+                constexpr explicit operator bool() const {
+                    return ok();
+                }
+                
+                constexpr errorCode getCode() const {
+                    return code;
+                }
+                
+                constexpr uint64_t getOffset() const {
+                    return offset;
+                }
+                
+                constexpr uint32_t getIndex() const {
+                    return index;
+                }
+                
+                /**
+                 * @return The error string of the error code (see getErrorString()).
+                 */
+                constexpr const char* getMessage() const {
+                    return getErrorString(code);
+                }
+        };
+        
         void logToFile(std::string message, std::string fname); //TODO: Create function definition for this
     }
 }
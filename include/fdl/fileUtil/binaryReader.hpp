@@ -0,0 +1,167 @@
+#ifndef BINARYREADER_HPP
+#define BINARYREADER_HPP
+
+#include <string>
+#include <vector>
+
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/fileUtil/fileUtil.hpp"
+#include "fdl/fileUtil/mappedFile.hpp"
+
+namespace fdl {
+    /**
+     * @addtogroup fileUtil
+     * @{
+     */
+    namespace fileUtil {
+        
+        /**
+         * @brief A bounds-checked cursor over little-endian binary data.
+         *
+         * Reads integers, arrays and length-prefixed strings from a
+         * range of bytes in memory, such as a file read into a buffer
+         * or a mappedFile. Integers are converted from little-endian
+         * with byte swaps chosen at compile time, so on little-endian
+         * systems they're plain loads.
+         *
+         * Reading past the end of the range sets a fail state (checked
+         * with good()), yields zeros and leaves the cursor where the
+         * failed read started, so tell() gives the offset of the
+         * failure (except after read(), which copies what it can, as
+         * std::istream::read() does). To check a fixed-size record
+         * just once rather than field by field, skip() past the whole
+         * record and decode it from the returned pointer with
+         * loadLittleEndian().
+         *
+         * The reader doesn't own the bytes, which must outlive it.
+         */
+        class binaryReader {
+            private:
+                const uint8_t* data;
+                size_t size;
+                size_t pos;
+                bool fail;
+                
+            public:
+                binaryReader(const uint8_t* data, const size_t size);
+                explicit binaryReader(const std::vector <uint8_t>& buffer);
+                explicit binaryReader(const mappedFile& file);
+                
+                bool good() const;
+                size_t tell() const;
+                size_t getSize() const;
+                
+                /**
+                 * @return The number of bytes after the cursor.
+                 */
+                size_t getRemaining() const;
+                
+                /**
+                 * Skips count bytes and returns a pointer to the first
+                 * of them, or nullptr if fewer than count bytes remain.
+                 */
+                const uint8_t* skip(const size_t count);
+                
+                uint8_t get();
+                
+                /**
+                 * Copies count bytes to dest. Like std::istream::read(),
+                 * whatever bytes remain are copied before failing.
+                 */
+                void read(void* dest, const size_t count);
+                
+                void ignore(const size_t count);
+                
+                /**
+                 * @return The little-endian integer of type T at the
+                 *         cursor, or 0 if it doesn't fit in the data.
+                 */
+                template <typename T>
+                T read();
+                
+                /**
+                 * @brief Reads an array of little-endian integers.
+                 *
+                 * Copies count integers of type T to dest with a single
+                 * copy, converting them all afterwards on big-endian
+                 * systems. Nothing is read if they don't all fit.
+                 *
+                 * @return True if the integers were read, false otherwise.
+                 */
+                template <typename T>
+                bool readArray(T* dest, const size_t count);
+                
+                /**
+                 * @brief Reads a string preceded by its length in one byte.
+                 *
+                 * The string's storage is reused, so reading many strings
+                 * into the same one only allocates for the longest. Like
+                 * a C string, it ends at its first null character, if it
+                 * has one.
+                 *
+                 * @return True if the string was read, false otherwise.
+                 */
+                bool readString(std::string& dest);
+                
+                /**
+                 * Reads a string preceded by its length in one byte into
+                 * a null-terminated character array that can hold capacity
+                 * characters including the terminator. If it's too long,
+                 * nothing is copied and the fail state is set.
+                 *
+                 * @return True if the string was read, false otherwise.
+                 */
+                bool readString(char* dest, const size_t capacity);
+        };
+        
+        inline const uint8_t* binaryReader::skip(const size_t count) {
+            if (count > size - pos) {
+                fail = true;
+                return nullptr;
+            }
+            
+            const uint8_t* const START = data + pos;
+            pos += count;
+            return START;
+        }
+        
+        template <typename T>
+        T binaryReader::read() {
+            const uint8_t* const IN = skip(sizeof(T));
+            return ((nullptr != IN) ? loadLittleEndian <T>(IN) : 0);
+        }
+        
+        template <typename T>
+        bool binaryReader::readArray(T* dest, const size_t count) {
+            if (count > getRemaining() / sizeof(T)) {
+                fail = true;
+                return false;
+            }
+            
+            const size_t BYTES = count * sizeof(T);
+            
+            if (BYTES > 0) {
+                memcpy(dest, skip(BYTES), BYTES);
+            }
+            
+            if (!LITTLE_ENDIAN_TARGET) { //folded away on little-endian systems; on big-endian ones the compiler can vectorize the swaps
+                for (size_t i = 0; i < count; ++i) {
+                    dest[i] = convertLittleEndian(dest[i]);
+                }
+            }
+            
+            return true;
+        }
+    }
+    /**
+     * @}
+     */
+}
+
+#endif //BINARYREADER_HPP
\ No newline at end of file
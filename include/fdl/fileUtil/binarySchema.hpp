@@ -0,0 +1,385 @@
+#ifndef BINARYSCHEMA_HPP
+#define BINARYSCHEMA_HPP
+
+#include <string>
+#include <array>
+#include <tuple>
+#include <type_traits>
+
+#include <algorithm> //find(InputIt first, InputIt last, const T& value)
+
+#include <cstdint>
+#include <cstddef>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count), memcmp(const void* lhs, const void* rhs, size_t count)
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace fileUtil {
+        
+        /**
+         * @brief Compile-time descriptions of binary file layouts.
+         *
+         * A layout is described once as a type, such as
+         * record <magic <HEADER, 8>, uint16LE, uint16LE>, and that
+         * one type both reads and writes it, so a reader and a writer
+         * can't drift apart. Each run of consecutive fixed-size fields
+         * is bounds checked with a single cursor call and then decoded
+         * straight from memory; only variable-size fields, such as
+         * length-prefixed strings, are read one at a time.
+         *
+         * Reading works with a binaryReader, or any cursor offering
+         * its skip() and readString(std::string&) methods. Values are
+         * read into and written from std::tuple objects (usually made
+         * with std::tie) for records, std::array objects for repeated
+         * fields, and integers, bools and strings otherwise. Multi-byte integers
+         * are little-endian regardless of the system's byte order.
+         *
+         * Every field type has IS_FIXED, SIZE (0 for variable-size
+         * fields), encode() and size(); fixed-size fields also have
+         * decode() and variable-size fields have read().
+         */
+        namespace schema {
+            namespace detail {
+                template <size_t I, typename... F>
+                struct fields;
+            }
+            
+            /**
+             * A single byte.
+             */
+            struct uint8 {
+                static constexpr bool IS_FIXED = true;
+                static constexpr size_t SIZE = 1;
+                
+                static void decode(const uint8_t* in, uint8_t& value) {
+                    value = *in;
+                }
+                
+                static uint8_t* encode(uint8_t* out, const uint8_t value) {
+                    *out = value;
+                    return out + SIZE;
+                }
+                
+                static size_t size(const uint8_t) {
+                    return SIZE;
+                }
+            };
+            
+            /**
+             * A little-endian 16-bit unsigned integer.
+             */
+            struct uint16LE {
+                static constexpr bool IS_FIXED = true;
+                static constexpr size_t SIZE = 2;
+                
+                static void decode(const uint8_t* in, uint16_t& value) {
+                    value = loadLittleEndian <uint16_t>(in);
+                }
+                
+                static uint8_t* encode(uint8_t* out, const uint16_t value) {
+                    return storeLittleEndian(out, value);
+                }
+                
+                static size_t size(const uint16_t) {
+                    return SIZE;
+                }
+            };
+            
+            /**
+             * N bytes that are stored as they are.
+             */
+            template <size_t N>
+            struct byteArray {
+                static constexpr bool IS_FIXED = true;
+                static constexpr size_t SIZE = N;
+                
+                static void decode(const uint8_t* in, std::array <uint8_t, N>& value) {
+                    memcpy(value.data(), in, N);
+                }
+                
+                static uint8_t* encode(uint8_t* out, const std::array <uint8_t, N>& value) {
+                    memcpy(out, value.data(), N);
+                    return out + N;
+                }
+                
+                static size_t size(const std::array <uint8_t, N>&) {
+                    return SIZE;
+                }
+            };
+            
+            /**
+             * @brief A constant sequence of bytes, such as a file header.
+             *
+             * Its value is a bool: reading sets it to whether the bytes
+             * in the file matched VALUE, and writing always writes VALUE.
+             * LENGTH may include VALUE's null terminator.
+             */
+            template <const char* VALUE, size_t LENGTH>
+            struct magic {
+                static constexpr bool IS_FIXED = true;
+                static constexpr size_t SIZE = LENGTH;
+                
+                static void decode(const uint8_t* in, bool& value) {
+                    value = (0 == memcmp(in, VALUE, LENGTH));
+                }
+                
+                static uint8_t* encode(uint8_t* out, const bool) {
+                    memcpy(out, VALUE, LENGTH);
+                    return out + LENGTH;
+                }
+                
+                static size_t size(const bool) {
+                    return SIZE;
+                }
+            };
+            
+            /**
+             * @brief A string preceded by its length in one byte.
+             *
+             * Like a C string, a string read from a file ends at its
+             * first null character, if it has one.
+             */
+            struct lengthPrefixedString {
+                static constexpr bool IS_FIXED = false;
+                static constexpr size_t SIZE = 0;
+                
+                template <typename Cursor>
+                static bool read(Cursor& in, std::string& value) {
+                    return in.readString(value);
+                }
+                
+                static uint8_t* encode(uint8_t* out, const std::string& value) {
+                    *out++ = value.size();
+                    memcpy(out, value.data(), value.size());
+                    return out + value.size();
+                }
+                
+                static size_t size(const std::string& value) {
+                    return 1 + value.size();
+                }
+            };
+            
+            /**
+             * @brief A string preceded by its length in one byte, at most MAX characters long.
+             *
+             * Reading fails before anything is stored if the length is
+             * over MAX. Unlike running out of data, that doesn't set the
+             * cursor's fail state, so callers can tell the two apart with
+             * the cursor's good() method.
+             */
+            template <size_t MAX>
+            struct boundedString {
+                static constexpr bool IS_FIXED = false;
+                static constexpr size_t SIZE = 0;
+                
+                template <typename Cursor>
+                static bool read(Cursor& in, std::string& value) {
+                    const uint8_t* const LENGTH = in.skip(1);
+                    
+                    if (nullptr == LENGTH || *LENGTH > MAX) {
+                        return false;
+                    }
+                    
+                    const uint8_t* const START = in.skip(*LENGTH);
+                    
+                    if (nullptr == START) {
+                        return false;
+                    }
+                    
+                    value.assign(START, std::find(START, START + *LENGTH, '\0'));
+                    return true;
+                }
+                
+                static uint8_t* encode(uint8_t* out, const std::string& value) {
+                    return lengthPrefixedString::encode(out, value);
+                }
+                
+                static size_t size(const std::string& value) {
+                    return lengthPrefixedString::size(value);
+                }
+            };
+            
+            /**
+             * N consecutive fields of type F, read into and
+             * written from an std::array of N values.
+             */
+            template <size_t N, typename F>
+            struct repeat {
+                static constexpr bool IS_FIXED = F::IS_FIXED;
+                static constexpr size_t SIZE = N * F::SIZE;
+                
+                template <typename T>
+                static void decode(const uint8_t* in, std::array <T, N>& value) {
+                    for (size_t i = 0; i < N; ++i) {
+                        F::decode(in + i * F::SIZE, value[i]);
+                    }
+                }
+                
+                template <typename Cursor, typename T>
+                static bool read(Cursor& in, std::array <T, N>& value) {
+                    for (size_t i = 0; i < N; ++i) {
+                        if (!F::read(in, value[i])) {
+                            return false;
+                        }
+                    }
+                    
+                    return true;
+                }
+                
+                template <typename T>
+                static uint8_t* encode(uint8_t* out, const std::array <T, N>& value) {
+                    for (size_t i = 0; i < N; ++i) {
+                        out = F::encode(out, value[i]);
+                    }
+                    
+                    return out;
+                }
+                
+                template <typename T>
+                static size_t size(const std::array <T, N>& value) {
+                    size_t total = 0;
+                    
+                    for (size_t i = 0; i < N; ++i) {
+                        total += F::size(value[i]);
+                    }
+                    
+                    return total;
+                }
+            };
+            
+            /**
+             * @brief Fields of types F... stored one after another.
+             *
+             * Read into and written from an std::tuple with one element
+             * per field. A record of only fixed-size fields is itself
+             * fixed-size, so it merges into the runs of any record or
+             * repeat containing it.
+             */
+            template <typename... F>
+            struct record {
+                static constexpr bool IS_FIXED = detail::fields <0, F...>::ALL_FIXED;
+                static constexpr size_t SIZE = (IS_FIXED ? detail::fields <0, F...>::RUN_SIZE : 0);
+                
+                template <typename T>
+                static void decode(const uint8_t* in, T& value) {
+                    detail::fields <0, F...>::decode(in, value);
+                }
+                
+                /**
+                 * Reads the record from the given cursor.
+                 *
+                 * @return True if the cursor held the whole record,
+                 *         false otherwise, in which case value may have
+                 *         been partly read.
+                 */
+                template <typename Cursor, typename T>
+                static bool read(Cursor& in, T&& value) {
+                    return detail::fields <0, F...>::read(in, value, nullptr, std::false_type());
+                }
+                
+                /**
+                 * Writes the record to out, which must have room
+                 * for size(value) bytes.
+                 *
+                 * @return The position just past what was written.
+                 */
+                template <typename T>
+                static uint8_t* encode(uint8_t* out, const T& value) {
+                    return detail::fields <0, F...>::encode(out, value);
+                }
+                
+                template <typename T>
+                static size_t size(const T& value) {
+                    return detail::fields <0, F...>::size(value);
+                }
+            };
+            
+            namespace detail {
+                //The fields of a record from index I on. Which of the read() overloads is used for each field is
+                //picked at compile time from whether it's fixed-size and whether it continues a run already checked.
+                
+                template <size_t I>
+                struct fields <I> {
+                    static constexpr bool ALL_FIXED = true;
+                    static constexpr size_t RUN_SIZE = 0;
+                    
+                    template <typename T>
+                    static void decode(const uint8_t*, T&) {}
+                    
+                    template <typename Cursor, typename T, bool IN_RUN>
+                    static bool read(Cursor&, T&, const uint8_t*, std::integral_constant <bool, IN_RUN>) {
+                        return true;
+                    }
+                    
+                    template <typename T>
+                    static uint8_t* encode(uint8_t* out, const T&) {
+                        return out;
+                    }
+                    
+                    template <typename T>
+                    static size_t size(const T&) {
+                        return 0;
+                    }
+                };
+                
+                template <size_t I, typename F, typename... R>
+                struct fields <I, F, R...> {
+                    typedef fields <I + 1, R...> next;
+                    
+                    static constexpr bool ALL_FIXED = (F::IS_FIXED && next::ALL_FIXED);
+                    static constexpr size_t RUN_SIZE = (F::IS_FIXED ? F::SIZE + next::RUN_SIZE : 0); //size of the run of fixed-size fields starting here
+                    
+                    template <typename T>
+                    static void decode(const uint8_t* in, T& value) {
+                        F::decode(in, std::get <I>(value));
+                        next::decode(in + F::SIZE, value);
+                    }
+                    
+                    template <typename Cursor, typename T, bool IN_RUN>
+                    static bool read(Cursor& in, T& value, const uint8_t* run, std::integral_constant <bool, IN_RUN> inRun) {
+                        return read(in, value, run, std::integral_constant <bool, F::IS_FIXED>(), inRun);
+                    }
+                    
+                    //first fixed-size field of a run; check the whole run at once
+                    template <typename Cursor, typename T>
+                    static bool read(Cursor& in, T& value, const uint8_t*, std::true_type, std::false_type) {
+                        const uint8_t* const RUN = in.skip(RUN_SIZE);
+                        
+                        if (nullptr == RUN) {
+                            return false;
+                        }
+                        
+                        return read(in, value, RUN, std::true_type(), std::true_type());
+                    }
+                    
+                    //fixed-size field in a run that's already been checked
+                    template <typename Cursor, typename T>
+                    static bool read(Cursor& in, T& value, const uint8_t* run, std::true_type, std::true_type) {
+                        F::decode(run, std::get <I>(value));
+                        return next::read(in, value, run + F::SIZE, std::true_type());
+                    }
+                    
+                    //variable-size field, which ends any run
+                    template <typename Cursor, typename T, bool IN_RUN>
+                    static bool read(Cursor& in, T& value, const uint8_t*, std::false_type, std::integral_constant <bool, IN_RUN>) {
+                        return F::read(in, std::get <I>(value)) && next::read(in, value, nullptr, std::false_type());
+                    }
+                    
+                    template <typename T>
+                    static uint8_t* encode(uint8_t* out, const T& value) {
+                        return next::encode(F::encode(out, std::get <I>(value)), value);
+                    }
+                    
+                    template <typename T>
+                    static size_t size(const T& value) {
+                        return F::size(std::get <I>(value)) + next::size(value);
+                    }
+                };
+            }
+        }
+    }
+}
+
+#endif //BINARYSCHEMA_HPP
\ No newline at end of file
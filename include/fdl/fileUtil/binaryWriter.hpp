@@ -0,0 +1,137 @@
+#ifndef BINARYWRITER_HPP
+#define BINARYWRITER_HPP
+
+#include <string>
+#include <vector>
+
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    /**
+     * @addtogroup fileUtil
+     * @{
+     */
+    namespace fileUtil {
+        
+        /**
+         * @brief A bounds-checked cursor for writing little-endian binary data.
+         *
+         * The counterpart of binaryReader: writes integers, arrays and
+         * length-prefixed strings to a range of bytes in memory.
+         * Writing past the end of the range writes nothing, sets a
+         * fail state (checked with good()) and leaves the cursor where
+         * it was. To check a fixed-size
+         * record just once, reserve() room for the whole record and
+         * fill it with storeLittleEndian().
+         *
+         * The writer doesn't own the bytes, which must outlive it.
+         */
+        class binaryWriter {
+            private:
+                uint8_t* data;
+                size_t size;
+                size_t pos;
+                bool fail;
+                
+            public:
+                binaryWriter(uint8_t* data, const size_t size);
+                explicit binaryWriter(std::vector <uint8_t>& buffer);
+                
+                bool good() const;
+                size_t tell() const;
+                size_t getSize() const;
+                size_t getRemaining() const;
+                
+                /**
+                 * Moves past count bytes and returns a pointer to the
+                 * first of them for the caller to fill, or nullptr if
+                 * fewer than count bytes remain.
+                 */
+                uint8_t* reserve(const size_t count);
+                
+                void put(const uint8_t value);
+                void write(const void* src, const size_t count);
+                
+                /**
+                 * Writes an integer of type T as little-endian. T must
+                 * be given explicitly (as in write <uint16_t>(x)) so
+                 * the number of bytes written is never a surprise.
+                 */
+                template <typename T>
+                void write(const typename std::common_type <T>::type value);
+                
+                /**
+                 * Writes count integers of type T as little-endian.
+                 * Nothing is written if they don't all fit.
+                 *
+                 * @return True if the integers were written, false otherwise.
+                 */
+                template <typename T>
+                bool writeArray(const T* src, const size_t count);
+                
+                /**
+                 * Writes a string preceded by its length in one byte.
+                 * Nothing is written if it's longer than 255 characters
+                 * or doesn't fit.
+                 *
+                 * @return True if the string was written, false otherwise.
+                 */
+                bool writeString(const std::string& str);
+        };
+        
+        inline uint8_t* binaryWriter::reserve(const size_t count) {
+            if (count > size - pos) {
+                fail = true;
+                return nullptr;
+            }
+            
+            uint8_t* const START = data + pos;
+            pos += count;
+            return START;
+        }
+        
+        template <typename T>
+        void binaryWriter::write(const typename std::common_type <T>::type value) { //std::common_type keeps T from being deduced
+            uint8_t* const OUT = reserve(sizeof(T));
+            
+            if (nullptr != OUT) {
+                storeLittleEndian <T>(OUT, value);
+            }
+        }
+        
+        template <typename T>
+        bool binaryWriter::writeArray(const T* src, const size_t count) {
+            if (count > getRemaining() / sizeof(T)) {
+                fail = true;
+                return false;
+            }
+            
+            uint8_t* out = reserve(count * sizeof(T));
+            
+            if (LITTLE_ENDIAN_TARGET) {
+                if (count > 0) {
+                    memcpy(out, src, count * sizeof(T));
+                }
+            }
+            else {
+                for (size_t i = 0; i < count; ++i) {
+                    out = storeLittleEndian(out, src[i]);
+                }
+            }
+            
+            return true;
+        }
+    }
+    /**
+     * @}
+     */
+}
+
+#endif //BINARYWRITER_HPP
\ No newline at end of file
@@ -2,12 +2,20 @@
 #define FILEUTIL_HPP
 
 #include <string>
+#include <vector>
 
 #include <fstream>
 
 #include <exception>
 
+#include <type_traits>
+
 #include <cstdint>
+#include <cstddef>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/errorUtil/errorUtil.hpp"
 
 namespace fdl {
     /**
@@ -45,6 +53,94 @@ namespace fdl {
             return ((x >> 8) | (x << 8));
         }
         
+        /**
+         * Swaps the bytes of a given 32-bit integer.
+         */
+        inline uint32_t byteswapUInt32(const uint32_t x) {
+            return ((x >> 24) | ((x >> 8) & 0x0000FF00) | ((x << 8) & 0x00FF0000) | (x << 24));
+        }
+        
+        /**
+         * Swaps the bytes of a given 64-bit integer.
+         */
+        inline uint64_t byteswapUInt64(const uint64_t x) {
+            return ((uint64_t)byteswapUInt32(x) << 32) | byteswapUInt32(x >> 32);
+        }
+        
+        /**
+         * Whether the program is being compiled for a little-endian
+         * system. Unlike isLittleEndian(), this is known at compile
+         * time, so code that depends on it has no runtime branches.
+         * Compilers that don't report their target's byte order are
+         * assumed to target a little-endian system.
+         */
+        #if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        constexpr bool LITTLE_ENDIAN_TARGET = false;
+        #else
+        constexpr bool LITTLE_ENDIAN_TARGET = true;
+        #endif
+        
+        namespace detail {
+            //byte swaps picked at compile time from the size of the value
+            
+            template <typename T>
+            inline T swapBytes(const T value, std::integral_constant <size_t, 1>) {
+                return value;
+            }
+            
+            template <typename T>
+            inline T swapBytes(const T value, std::integral_constant <size_t, 2>) {
+                return static_cast <T>(byteswapUInt16(static_cast <uint16_t>(value)));
+            }
+            
+            template <typename T>
+            inline T swapBytes(const T value, std::integral_constant <size_t, 4>) {
+                return static_cast <T>(byteswapUInt32(static_cast <uint32_t>(value)));
+            }
+            
+            template <typename T>
+            inline T swapBytes(const T value, std::integral_constant <size_t, 8>) {
+                return static_cast <T>(byteswapUInt64(static_cast <uint64_t>(value)));
+            }
+        }
+        
+        /**
+         * Converts an integer between the system's byte order and
+         * little-endian (the conversion is the same both ways). On
+         * little-endian systems it does nothing and compiles away.
+         */
+        template <typename T>
+        inline T convertLittleEndian(const T value) {
+            static_assert(std::is_integral <T>::value && !std::is_same <T, bool>::value,
+                          "Only integers can be converted between byte orders.");
+            
+            return (LITTLE_ENDIAN_TARGET ? value : detail::swapBytes(value, std::integral_constant <size_t, sizeof(T)>()));
+        }
+        
+        /**
+         * @return The little-endian integer stored at the given
+         *         address, which doesn't need to be aligned.
+         */
+        template <typename T>
+        inline T loadLittleEndian(const uint8_t* in) {
+            T value;
+            memcpy(&value, in, sizeof(T));
+            return convertLittleEndian(value);
+        }
+        
+        /**
+         * Stores an integer as little-endian at the given address,
+         * which doesn't need to be aligned.
+         *
+         * @return The address just past the stored integer.
+         */
+        template <typename T>
+        inline uint8_t* storeLittleEndian(uint8_t* out, const T value) {
+            const T CONVERTED = convertLittleEndian(value);
+            memcpy(out, &CONVERTED, sizeof(T));
+            return out + sizeof(T);
+        }
+        
         /**
          * @brief Strip the path from a filepath.
          *
@@ -99,6 +195,74 @@ namespace fdl {
          *         otherwise.
          */
         bool fileExists(const std::string& fname);
+        
+        /**
+         * Stores the size and last modification time of a file.
+         */
+        struct fileStatus {
+            uint64_t size = 0;
+            int64_t modifiedTime = 0; /**< In nanoseconds since the epoch */
+        };
+        
+        /**
+         * Gets the size and last modification time of
+         * the file with the given name.
+         *
+         * @param fname Name of the file to check.
+         * @param status Where the file's status is stored.
+         *
+         * @return True if the file's status was retrieved,
+         *         false otherwise (such as if it doesn't exist).
+         */
+        bool getFileStatus(const std::string& fname, fileStatus& status);
+        
+        /**
+         * @brief Reads a whole file into memory with a single read.
+         *
+         * The buffer's storage is reused, so reading many files into
+         * the same buffer only allocates for the largest.
+         *
+         * @param fname Name of the file to read.
+         * @param buffer Where the file's contents are stored.
+         *
+         * @return SUCCESS, FILE_OPENFAIL if the file cannot be opened,
+         *         or FILE_READFAIL (with the offset at which reading
+         *         stopped) if it cannot be read in full.
+         */
+        fdl::errorUtil::result readFile(const std::string& fname, std::vector <uint8_t>& buffer);
+        
+        /**
+         * @brief Atomically replace a file's contents.
+         *
+         * Writes the given bytes to a uniquely named temporary
+         * file next to the given one, flushes it to disk and then
+         * renames it over the given file, so the file is either
+         * left untouched or completely replaced, even if several
+         * threads or processes save it at once or the system
+         * crashes partway through.
+         *
+         * @param fname Name of the file to write.
+         * @param data The bytes to write to the file.
+         * @param size The number of bytes to write.
+         *
+         * @return True if the file was written, false otherwise
+         *         (in which case the temporary file is removed).
+         */
+        bool writeFileAtomically(const std::string& fname, const uint8_t* data, const size_t size);
+        
+        /**
+         * Lists the files in a folder that have the given
+         * extension. An fdl::errorUtil::fileOpenError exception
+         * is thrown if the folder cannot be opened.
+         *
+         * @param folder The folder whose files will be listed.
+         * @param extension The extension (including '.') that
+         *                  listed files must have.
+         *
+         * @return The sorted names (without the folder) of all
+         *         files in the folder with the given extension.
+         */
+        std::vector <std::string> listFiles(const std::string& folder, const std::string& extension);
     }
     /**
      * @}
@@ -0,0 +1,89 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <memory>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fdl {
+    /**
+     * @addtogroup fileUtil
+     * @{
+     */
+    namespace fileUtil {
+        
+        /**
+         * @brief A read-only memory mapping of a file.
+         *
+         * Maps an entire file into memory for reading so that
+         * it can be parsed directly as a byte range instead of
+         * through stream calls. The mapping lasts as long as the
+         * object does, so anything pointing into data() must not
+         * outlive it (hold the object in an std::shared_ptr to
+         * share it safely).
+         */
+        class mappedFile {
+            private:
+                enum mapStatus {
+                    MAP_OK,
+                    MAP_OPENFAIL,
+                    MAP_STATFAIL,
+                    MAP_MMAPFAIL
+                };
+                
+                const uint8_t* bytes;
+                size_t length;
+                
+                mappedFile(const uint8_t* bytes, const size_t length);
+                
+                /**
+                 * Maps the given file, storing the mapping in bytes and
+                 * length if it succeeds.
+                 */
+                static mapStatus map(const std::string& fname, const uint8_t*& bytes, size_t& length);
+                
+            public:
+                /**
+                 * Maps the given file into memory. An
+                 * fdl::errorUtil::fileOpenError exception is
+                 * thrown if the file cannot be opened or mapped.
+                 *
+                 * @param fname Name of the file to map.
+                 */
+                explicit mappedFile(const std::string& fname);
+                ~mappedFile();
+                
+                /**
+                 * Maps the given file into memory without throwing,
+                 * for callers that expect some files to be missing.
+                 *
+                 * @param fname Name of the file to map.
+                 *
+                 * @return The mapping, or nullptr if the file cannot be
+                 *         opened or mapped.
+                 */
+                static std::shared_ptr <const mappedFile> tryMap(const std::string& fname);
+                
+                mappedFile(const mappedFile&) = delete;
+                mappedFile& operator=(const mappedFile&) = delete;
+                
+                /**
+                 * @return A pointer to the first byte of the mapped file,
+                 *         or nullptr if the file is empty.
+                 */
+                const uint8_t* data() const;
+                
+                /**
+                 * @return The size of the mapped file in bytes.
+                 */
+                size_t size() const;
+        };
+    }
+    /**
+     * @}
+     */
+}
+
+#endif //MAPPEDFILE_HPP
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef IMAGE_HPP
+#define IMAGE_HPP
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fdl {
+    /**
+     * @addtogroup imageUtil
+     * @{
+     */
+    
+    /**
+     * @brief Image utility functions and classes.
+     *
+     * Namespace containing an in-memory RGBA image along
+     * with small encoders and decoders for image formats
+     * that need no external libraries.
+     */
+    namespace imageUtil {
+        /**
+         * An image held in memory as 4 bytes per pixel (red, green,
+         * blue and alpha), stored row by row with no padding.
+         */
+        struct rgbaImage {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector <uint8_t> pixels;
+            
+            rgbaImage() = default;
+            
+            /**
+             * Creates an image with every pixel set to the given colour.
+             */
+            rgbaImage(const uint32_t width, const uint32_t height, const std::array <uint8_t, 4>& colour = {{0, 0, 0, 0}});
+            
+            uint8_t* getRow(const uint32_t y) {
+                return pixels.data() + (size_t)y * width * 4;
+            }
+            
+            const uint8_t* getRow(const uint32_t y) const {
+                return pixels.data() + (size_t)y * width * 4;
+            }
+        };
+        
+        /**
+         * @brief Decodes a binary PPM (P6) or PAM (P7) image.
+         *
+         * Only images with a maximum value of 255 are supported.
+         * PPM images and PAM images with a depth of 3 are opaque;
+         * PAM images with a depth of 4 (RGB_ALPHA) keep their alpha.
+         *
+         * @param data Pointer to the first byte of the image file.
+         * @param size Size of the image file in bytes.
+         * @param image Where the decoded image is stored.
+         *
+         * @return True if the image was decoded, false otherwise
+         *         (in which case image is left empty).
+         */
+        bool decodeNetpbm(const uint8_t* data, const size_t size, rgbaImage& image);
+        
+        /**
+         * Loads a PPM or PAM image file with decodeNetpbm(). An
+         * fdl::errorUtil::fileOpenError exception is thrown if the
+         * file cannot be opened, and an fdl::errorUtil::fileReadError
+         * exception if it cannot be read or decoded.
+         *
+         * @param filename Path of the image file.
+         *
+         * @return The decoded image.
+         */
+        rgbaImage loadNetpbm(const std::string& filename);
+        
+        /**
+         * @return The image encoded as a binary PPM (P6) file,
+         *         which has no alpha channel, so alpha is dropped.
+         */
+        std::vector <uint8_t> encodePpm(const rgbaImage& image);
+        
+        /**
+         * @brief Encodes an image as a PNG file.
+         *
+         * The image data is stored uncompressed (in stored deflate
+         * blocks) so no compression library is needed. The file is
+         * therefore about as large as the raw pixels, but any PNG
+         * decoder can read it, and encoding runs at memory speed.
+         *
+         * @return The PNG file.
+         */
+        std::vector <uint8_t> encodePng(const rgbaImage& image);
+        
+        /**
+         * Writes an image as a PPM or PNG file, chosen by whether the
+         * filename ends in ".png". An fdl::errorUtil::fileWriteError
+         * exception is thrown if the file cannot be written.
+         */
+        void saveImage(const rgbaImage& image, const std::string& filename);
+    }
+    /**
+     * @}
+     */
+}
+
+#endif //IMAGE_HPP
\ No newline at end of file
@@ -0,0 +1,183 @@
+#ifndef BLOCKEDTILELAYER_HPP
+#define BLOCKEDTILELAYER_HPP
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "fdl/containerUtil/arrayView.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * @brief A tile layer stored as square blocks of tiles
+         *
+         * Alternative to pxPack::tileLayer for very large layers. It has
+         * the same interface for reading and editing tiles, but stores them
+         * in 16x16 or 32x32 blocks, each contiguous, instead of one row-major
+         * array. Reading or writing a small square region then touches a few
+         * blocks rather than one cache line per row, and resizing only
+         * moves block pointers and clears the blocks along the new edges.
+         * Blocks that have only ever held tile 0 aren't allocated at all.
+         * Since tiles aren't contiguous, there's no getTileView(); use
+         * readRegion() or getBlockView() instead.
+         */
+        class blockedTileLayer {
+            public:
+                static constexpr int SMALL_BLOCK_SHIFT = 4; /**< 16x16 blocks */
+                static constexpr int LARGE_BLOCK_SHIFT = 5; /**< 32x32 blocks */
+                
+            private:
+                uint16_t width, height;
+                uint8_t flag;
+                
+                int blockShift;
+                size_t blockColumns, blockRows;
+                
+                /*
+                 * Blocks in row-major order, each holding its tiles in row-major
+                 * order. A null block is all 0s. Tiles of edge blocks that lie
+                 * outside the layer are always 0, so whole blocks can be scanned
+                 * or compared without checking the layer's bounds.
+                 */
+                std::vector <std::unique_ptr <uint8_t []>> blocks;
+                
+            public:
+                /**
+                 * Creates an empty layer. An std::invalid_argument exception
+                 * is thrown if blockShift isn't SMALL_BLOCK_SHIFT or
+                 * LARGE_BLOCK_SHIFT.
+                 *
+                 * @param blockShift Base-2 logarithm of the width of each block.
+                 */
+                explicit blockedTileLayer(const int blockShift = LARGE_BLOCK_SHIFT);
+                
+                /**
+                 * Creates a layer holding a copy of the given layer.
+                 */
+                explicit blockedTileLayer(const pxPack::tileLayer& layer, const int blockShift = LARGE_BLOCK_SHIFT);
+                
+                blockedTileLayer(const blockedTileLayer& other);
+                blockedTileLayer& operator=(const blockedTileLayer& other);
+                blockedTileLayer(blockedTileLayer&&) = default;
+                blockedTileLayer& operator=(blockedTileLayer&&) = default;
+                
+                uint16_t getWidth() const;
+                uint16_t getHeight() const;
+                uint8_t getFlag() const;
+                
+                /**
+                 * @return Every tile in the layer, row by row.
+                 */
+                std::vector <uint8_t> getTiles() const;
+                
+                /**
+                 * Returns the tile at the given coordinates. An
+                 * std::out_of_range exception is thrown if the
+                 * coordinates are outside the layer.
+                 */
+                uint8_t getTile(const uint16_t x, const uint16_t y) const;
+                
+                /**
+                 * Copies the layer into the given row-major tile layer.
+                 */
+                void copyTo(pxPack::tileLayer& layer) const;
+                
+                void reset();
+                
+                void setDimensions(const uint16_t width, const uint16_t height);
+                void setFlag(const uint8_t flag);
+                void setTile(const uint16_t x, const uint16_t y, const uint8_t tile);
+                
+                /**
+                 * Sets the layer's dimensions and copies all of its tiles
+                 * from the given buffer of width * height tiles stored
+                 * row by row.
+                 */
+                void setTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles);
+                
+                //REGIONS AND BLOCKS
+                
+                /**
+                 * Copies a rectangle of tiles, row by row, into the given
+                 * buffer of width * height tiles. An std::out_of_range
+                 * exception is thrown if the rectangle extends outside
+                 * the layer.
+                 */
+                void readRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                uint8_t* destination) const;
+                
+                /**
+                 * Copies a rectangle of tiles from the given buffer of
+                 * width * height tiles stored row by row. An
+                 * std::out_of_range exception is thrown if the rectangle
+                 * extends outside the layer.
+                 */
+                void writeRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                 const uint8_t* source);
+                
+                int getBlockShift() const;
+                size_t getBlockColumns() const;
+                size_t getBlockRows() const;
+                
+                /**
+                 * Views the tiles of one block, row by row. Tiles past the
+                 * layer's right or bottom edge read as 0. The view is
+                 * invalidated by any call that changes the layer's
+                 * dimensions or writes to the block. An std::out_of_range
+                 * exception is thrown if the block is outside the layer.
+                 *
+                 * @param blockX Column of the block.
+                 * @param blockY Row of the block.
+                 */
+                fdl::containerUtil::arrayView <const uint8_t> getBlockView(const size_t blockX, const size_t blockY) const;
+                
+                /**
+                 * @return The number of blocks holding anything but 0s.
+                 */
+                size_t getNumAllocatedBlocks() const;
+                
+                //BULK OPERATIONS (as in pxPack::tileLayer)
+                
+                void fillRect(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                              const uint8_t tile);
+                size_t replaceTile(const uint8_t from, const uint8_t to);
+                std::array <size_t, 256> getHistogram() const;
+                
+                /**
+                 * Counts the tiles that differ between this layer and
+                 * another. An std::invalid_argument exception is thrown
+                 * if the layers' dimensions differ.
+                 */
+                size_t countDifferences(const blockedTileLayer& other) const;
+                
+            private:
+                size_t getBlockSize() const;
+                
+                /**
+                 * @return The given block, allocating it (filled
+                 *         with 0s) if it's null.
+                 */
+                uint8_t* getWritableBlock(const size_t blockX, const size_t blockY);
+                
+                void checkRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                 const std::string& action) const;
+                
+                /**
+                 * Calls f(block index, offset of the run in the block, offset
+                 * of the run in a row-major copy of the rectangle, length) for
+                 * each run of the rectangle that lies within one row of one
+                 * block, block by block.
+                 */
+                template <typename F>
+                void forEachRun(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height, F f) const;
+        };
+    }
+}
+
+#endif //BLOCKEDTILELAYER_HPP
\ No newline at end of file
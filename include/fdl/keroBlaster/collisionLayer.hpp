@@ -0,0 +1,189 @@
+#ifndef COLLISIONLAYER_HPP
+#define COLLISIONLAYER_HPP
+
+#include <vector>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * @brief A bit-packed map of tile attributes derived from a tile layer
+         *
+         * Looks up each tile of a tile layer in an attribute table (such as
+         * which tiles are solid, or what kind of slope or hazard they are)
+         * and packs the results into 64-bit words at 1 to 4 bits per cell,
+         * each row starting on a new word. Queries over a region test up to
+         * 64 cells per word instead of reading and looking up one tile at a
+         * time, and touch 2 to 8 times less memory than the tiles themselves.
+         *
+         * The collision layer attaches itself to its tile layer. A tile
+         * changed through setTile() updates its cell, and other edits made
+         * through the layer, a tileLayerHistory or the algorithms in
+         * fdl/containerUtil/tileGrid.hpp update the rows they touched.
+         * Only one collision layer can be attached to a tile layer at a
+         * time. If the tile layer is destroyed first, the collision layer
+         * is left detached and its queries throw an std::logic_error exception.
+         *
+         * Regions may extend outside the tile layer; cells
+         * outside it are treated as having an attribute of 0.
+         */
+        class collisionLayer {
+            friend class pxPack::tileLayer;
+            
+            public:
+                static constexpr int MAX_BITS_PER_CELL = 4;
+                
+            private:
+                pxPack::tileLayer* layer;
+                
+                int bitsPerCell;
+                int slotBits; //bits each cell takes up in a word, which is bitsPerCell rounded up to a power of 2
+                uint64_t laneOnes; //the lowest bit of every cell's slot
+                int cellShift; //base-2 logarithm of the number of cells in each word
+                std::array <uint8_t, 256> attributes;
+                
+                uint16_t width, height;
+                size_t wordsPerRow;
+                std::vector <uint64_t> words;
+                
+            public:
+                /**
+                 * Builds a collision layer over the given tile layer and
+                 * attaches it to the layer. An std::logic_error exception
+                 * is thrown if the tile layer already has a collision layer
+                 * attached, and an std::invalid_argument exception if
+                 * bitsPerCell isn't between 1 and MAX_BITS_PER_CELL or an
+                 * attribute doesn't fit in bitsPerCell bits.
+                 *
+                 * @param layer The tile layer to follow.
+                 * @param attributes The attribute of each tile value.
+                 * @param bitsPerCell Bits needed to hold each attribute.
+                 */
+                collisionLayer(pxPack::tileLayer& layer, const std::array <uint8_t, 256>& attributes, const int bitsPerCell = 1);
+                
+                collisionLayer(const collisionLayer&) = delete;
+                collisionLayer& operator=(const collisionLayer&) = delete;
+                
+                /**
+                 * Detaches the collision layer from its tile layer.
+                 */
+                ~collisionLayer();
+                
+                int getBitsPerCell() const;
+                const std::array <uint8_t, 256>& getAttributes() const;
+                
+                /**
+                 * Replaces the attribute table and rebuilds every cell. An
+                 * std::invalid_argument exception is thrown if an attribute
+                 * doesn't fit in getBitsPerCell() bits.
+                 */
+                void setAttributes(const std::array <uint8_t, 256>& attributes);
+                
+                /**
+                 * Returns the attribute of the cell at the given
+                 * coordinates. An std::out_of_range exception is
+                 * thrown if the coordinates are outside the layer.
+                 */
+                uint8_t getCell(const uint16_t x, const uint16_t y) const;
+                
+                /**
+                 * Checks whether any cell in the given rectangle has an
+                 * attribute sharing a bit with mask, such as whether a
+                 * bounding box overlaps a solid tile.
+                 *
+                 * @param x Left edge of the rectangle.
+                 * @param y Top edge of the rectangle.
+                 * @param width Width of the rectangle; x + width is just outside it.
+                 * @param height Height of the rectangle; y + height is just outside it.
+                 * @param mask Attribute bits to look for.
+                 */
+                bool anyInRect(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                               const uint8_t mask = UINT8_MAX) const;
+                
+                /**
+                 * @return The number of cells in the given rectangle (as in
+                 *         anyInRect()) with an attribute sharing a bit with mask.
+                 */
+                size_t countInRect(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                   const uint8_t mask = UINT8_MAX) const;
+                
+                /**
+                 * @brief Sweeps a box sideways until it hits a cell.
+                 *
+                 * Moves the given box dx cells to the right (or left if dx
+                 * is negative) and stops it before the first column holding
+                 * a cell whose attribute shares a bit with mask. Only the
+                 * columns the box moves into are checked, so a box already
+                 * overlapping such cells can still move out of them.
+                 *
+                 * @return How many cells the box can move, from 0 to |dx|.
+                 */
+                uint32_t sweepHorizontal(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                         const int32_t dx, const uint8_t mask = UINT8_MAX) const;
+                
+                /**
+                 * Moves the given box dy cells down (or up if dy is negative),
+                 * as sweepHorizontal() does sideways. Diagonal moves can be
+                 * swept one axis at a time.
+                 *
+                 * @return How many cells the box can move, from 0 to |dy|.
+                 */
+                uint32_t sweepVertical(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                       const int32_t dy, const uint8_t mask = UINT8_MAX) const;
+                
+                /**
+                 * Rebuilds every cell from the tile layer's current tiles.
+                 * Done automatically when needed.
+                 */
+                void rebuild();
+                
+            private:
+                void checkAttached() const;
+                void checkAttributes(const std::array <uint8_t, 256>& attributes) const;
+                
+                /**
+                 * @return The bits of a column that give its cell's
+                 *         position within its word.
+                 */
+                size_t getCellMask() const;
+                
+                /**
+                 * Sets the cell at the given row-major index from
+                 * the tile now there. Called by tileLayer::setTile().
+                 */
+                void update(const size_t index, const uint8_t tile);
+                
+                /**
+                 * Rebuilds the cells of the given rows. Called by
+                 * tileLayer once its tiles are written directly.
+                 */
+                void rebuildRows(const uint16_t firstRow, const uint16_t endRow);
+                
+                /**
+                 * @return A word with the lowest bit of each cell's slot set
+                 *         if that cell's attribute shares a bit with mask.
+                 */
+                uint64_t matchCells(const uint64_t word, const uint8_t mask) const;
+                
+                /**
+                 * Calls f(word index in the row, matches) for each word of
+                 * the given row holding cells in [first, end), in order from
+                 * the left or the right, where matches is as returned by
+                 * matchCells() with cells outside the range cleared. Stops
+                 * early once f returns true.
+                 *
+                 * @return Whether f returned true.
+                 */
+                template <typename F>
+                bool scanRow(const uint16_t y, const uint16_t first, const uint16_t end, const uint8_t mask,
+                             const bool fromRight, F f) const;
+        };
+    }
+}
+
+#endif //COLLISIONLAYER_HPP
\ No newline at end of file
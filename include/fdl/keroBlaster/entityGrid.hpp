@@ -0,0 +1,140 @@
+#ifndef ENTITYGRID_HPP
+#define ENTITYGRID_HPP
+
+#include <vector>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * @brief A uniform grid over the entities of an entityTable
+         *
+         * Spatial index that buckets entities into square cells by their
+         * coordinates, so that finding the entities in a region or the
+         * nearest entity of some type only visits nearby cells rather than
+         * every entity. The grid attaches itself to its table and is updated
+         * whenever entities are added, cleared or moved through the table's
+         * setX() and setY(). Only one grid can be attached to a table at a
+         * time. If the table is destroyed first, the grid is left detached
+         * and its queries throw an std::logic_error exception.
+         */
+        class entityGrid {
+            friend class pxPack::entityTable;
+            
+            public:
+                static constexpr int DEFAULT_CELL_SHIFT = 4; /**< Cells are 16x16 by default */
+                static constexpr int MAX_CELL_SHIFT = 16; /**< A single cell covers every possible coordinate */
+                
+                /**
+                 * Most cells a grid holds. Cells are made wider
+                 * when entities are spread too far apart for
+                 * the requested cell size.
+                 */
+                static constexpr size_t MAX_NUM_CELLS = 1 << 16;
+                
+            private:
+                pxPack::entityTable* table;
+                
+                int requestedCellShift; //as given to the constructor, which each resize starts from again
+                int cellShift;
+                size_t columns;
+                size_t rows;
+                
+                //indices of the entities in each cell, in row-major order, and where each entity sits within its cell
+                std::vector <std::vector <uint16_t>> cells;
+                std::vector <uint32_t> slots;
+                
+            public:
+                /**
+                 * Builds a grid over the entities in the given table and
+                 * attaches it to the table. An std::logic_error exception is
+                 * thrown if the table already has a grid attached, and an
+                 * std::invalid_argument exception if cellShift is negative
+                 * or greater than MAX_CELL_SHIFT.
+                 *
+                 * @param cellShift Base-2 logarithm of the width of each cell.
+                 */
+                explicit entityGrid(pxPack::entityTable& table, const int cellShift = DEFAULT_CELL_SHIFT);
+                
+                entityGrid(const entityGrid&) = delete;
+                entityGrid& operator=(const entityGrid&) = delete;
+                
+                /**
+                 * Detaches the grid from its table.
+                 */
+                ~entityGrid();
+                
+                /**
+                 * @return Base-2 logarithm of the width of each cell, which
+                 *         may be greater than requested (see MAX_NUM_CELLS).
+                 */
+                int getCellShift() const;
+                
+                /**
+                 * Finds every entity whose coordinates lie in the given
+                 * rectangle, in no particular order. Results are appended
+                 * to the given vector so its storage can be reused between
+                 * queries.
+                 *
+                 * @param x Left edge of the rectangle.
+                 * @param y Top edge of the rectangle.
+                 * @param width Width of the rectangle; x + width is just outside it.
+                 * @param height Height of the rectangle; y + height is just outside it.
+                 * @param results Vector to which indices into the table are appended.
+                 */
+                void findInRect(const uint16_t x, const uint16_t y, const uint32_t width, const uint32_t height,
+                                std::vector <size_t>& results) const;
+                
+                /**
+                 * Finds the entity of the given type closest (by Euclidean
+                 * distance) to the given point. Ties go to the lowest index.
+                 * Cells are searched in rings around the point, so a type
+                 * that's absent or only far away can take a scan of the
+                 * whole grid.
+                 *
+                 * @param index Set to the entity's index in the table if one is found.
+                 *
+                 * @return Whether the table holds an entity of the given type.
+                 */
+                bool findNearest(const uint16_t x, const uint16_t y, const uint8_t type, size_t& index) const;
+                
+                /**
+                 * Rebuilds the grid from the table's current contents,
+                 * shrinking it to fit. Done automatically when needed.
+                 */
+                void rebuild();
+                
+            private:
+                void checkAttached() const;
+                
+                size_t getCellIndex(const uint16_t x, const uint16_t y) const;
+                
+                /**
+                 * Adds the entity at the given index, growing
+                 * the grid if it's outside the area covered.
+                 */
+                void insert(const size_t index);
+                
+                /**
+                 * Moves the entity at the given index from the cell
+                 * holding its old coordinates to its current one.
+                 */
+                void move(const size_t index, const uint16_t oldX, const uint16_t oldY);
+                
+                void removeFromCell(const size_t index, const size_t cell);
+                
+                /**
+                 * Resizes the grid to cover at least the given number
+                 * of columns and rows (of the current cell size) as
+                 * well as every entity, and refills it. Cells are made
+                 * as narrow as requested again wherever they fit.
+                 */
+                void resize(const size_t minColumns, const size_t minRows);
+        };
+    }
+}
+
+#endif //ENTITYGRID_HPP
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef MAPRENDERER_HPP
+#define MAPRENDERER_HPP
+
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "fdl/imageUtil/image.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * @brief A tileset image cut into square tiles for rendering.
+         *
+         * Tiles are numbered row by row from the top left of the
+         * image, as in Kero Blaster's tilesets, so tile t is in
+         * column t % getColumns() and row t / getColumns(). Each
+         * tile is classified once, when the atlas is made, as empty,
+         * opaque or masked, so rendering can skip empty tiles, copy
+         * opaque ones and blend only the rest.
+         */
+        class tilesetAtlas {
+            public:
+                enum tileCoverage : uint8_t {
+                    TILE_EMPTY, /**< Every pixel is transparent (or the tile is outside the image), so it's never drawn */
+                    TILE_OPAQUE, /**< No pixel is transparent, so its rows are copied as they are */
+                    TILE_MASKED /**< Some pixels are transparent, so its rows are blended */
+                };
+                
+                static constexpr uint32_t DEFAULT_TILE_SIZE = 8; /**< Width and height of a Kero Blaster tile in pixels */
+                
+            private:
+                fdl::imageUtil::rgbaImage image;
+                uint32_t tileSize;
+                uint32_t columns;
+                
+                std::array <tileCoverage, 256> coverage;
+                std::array <std::array <uint8_t, 4>, 256> averageColours;
+                
+            public:
+                tilesetAtlas();
+                
+                /**
+                 * Makes an atlas from a tileset image, such as raw RGBA
+                 * pixels or an image from fdl::imageUtil::loadNetpbm().
+                 * An std::invalid_argument exception is thrown if
+                 * tileSize is 0 or the image's dimensions aren't
+                 * multiples of it.
+                 *
+                 * @param image The tileset image.
+                 * @param tileSize Width and height of each tile in pixels.
+                 */
+                explicit tilesetAtlas(fdl::imageUtil::rgbaImage image, const uint32_t tileSize = DEFAULT_TILE_SIZE);
+                
+                const fdl::imageUtil::rgbaImage& getImage() const;
+                uint32_t getTileSize() const;
+                uint32_t getColumns() const;
+                
+                tileCoverage getCoverage(const uint8_t tile) const;
+                
+                /**
+                 * @return The average colour of the tile's visible pixels,
+                 *         which is fully transparent for an empty tile.
+                 */
+                const std::array <uint8_t, 4>& getAverageColour(const uint8_t tile) const;
+                
+                /**
+                 * @return A pointer to the getTileSize() RGBA pixels of the
+                 *         given row of the given tile, which mustn't be empty.
+                 */
+                const uint8_t* getTileRow(const uint8_t tile, const uint32_t row) const;
+        };
+        
+        /**
+         * Options for rendering tile layers.
+         */
+        struct renderOptions {
+            std::array <uint8_t, 4> background = {{0, 0, 0, 255}}; /**< Colour every pixel starts as */
+            std::array <bool, pxPack::NUM_LAYERS> drawLayers = {{true, true, true}}; /**< Which layers are drawn */
+            unsigned int maxThreads = 0; /**< Most threads to render with, or 0 to use one per hardware thread */
+            uint32_t bandHeight = 8; /**< Rows of tiles in each band of the image handed to a thread */
+        };
+        
+        /**
+         * @brief Renders a map's tile layers into an RGBA image.
+         *
+         * Layers are drawn from the last (the background) to the
+         * first (the foreground), each with its own atlas, starting
+         * from the top left of the image. The image is as large as
+         * the largest layer drawn. The image is split into bands of
+         * rows of tiles that are rendered concurrently, and each
+         * row of a tile is drawn with a single copy or SIMD blend
+         * (see fdl::containerUtil::blitPixels()).
+         *
+         * Layers whose atlas is null aren't drawn. An
+         * std::invalid_argument exception is thrown if the atlases
+         * of the layers drawn have different tile sizes.
+         *
+         * @param layers The tile layers to render.
+         * @param atlases The atlas for each layer's tileset.
+         * @param options How to render the layers.
+         *
+         * @return The rendered image.
+         */
+        fdl::imageUtil::rgbaImage renderTileLayers(const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& layers,
+                                                   const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                                   const renderOptions& options = renderOptions());
+        
+        /**
+         * Renders the tile layers of a map with renderTileLayers(),
+         * first finishing loading the map if it was loaded lazily.
+         */
+        fdl::imageUtil::rgbaImage renderMap(pxPack& map, const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                            const renderOptions& options = renderOptions());
+        
+        /**
+         * Renders a minimap of a map's tile layers, with one pixel
+         * per tile in the average colour of that tile, composited
+         * as in renderTileLayers(). options.maxThreads and
+         * options.bandHeight are ignored.
+         */
+        fdl::imageUtil::rgbaImage renderMinimap(const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& layers,
+                                                const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                                const renderOptions& options = renderOptions());
+    }
+}
+
+#endif //MAPRENDERER_HPP
\ No newline at end of file
@@ -4,16 +4,30 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <memory>
 
 #include <fstream>
 
 #include <cstdint>
 
 #include "fdl/containerUtil/containerUtil.hpp"
-#include "fdl/containerUtil/limitedAllocator.hpp"
+#include "fdl/containerUtil/arena.hpp"
+#include "fdl/containerUtil/arenaAllocator.hpp"
+#include "fdl/containerUtil/arrayView.hpp"
+#include "fdl/containerUtil/stringPool.hpp"
+#include "fdl/containerUtil/tileGrid.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/mappedFile.hpp"
+#include "fdl/fileUtil/binaryReader.hpp"
 
 namespace fdl {
     namespace keroBlaster {
+        class entityGrid;
+        class tileLayerHistory;
+        class collisionLayer;
+        
         class pxPack {
             public:
                 //CONSTANT VALUES
@@ -26,6 +40,20 @@ namespace fdl {
                 static constexpr int NUM_REFERENCED_MAPS = 3; /**< Number of map filenames that appear in the header of a PXPACK file */
                 static constexpr int NUM_REFERENCED_TILESETS = 3; /**< Number of tileset filenames that appear in the header of a PXPACK file */
                 
+                /**
+                 * Number of bytes following the spritesheet name
+                 * in the head of a PXPACK file. The purpose of
+                 * these bytes is currently unknown.
+                 */
+                static constexpr int NUM_UNKNOWN_HEAD_BYTES = 8;
+                
+                /**
+                 * Number of bytes following each tileset name
+                 * in the head of a PXPACK file. The purpose of
+                 * these bytes is currently unknown.
+                 */
+                static constexpr int NUM_UNKNOWN_TILESET_BYTES = 2;
+                
                 static constexpr int DESCRIPTION_MAX_LEN = 31; /**< Maximum length of the description text that appears in the header of a PXPACK file */
                 
                 static constexpr int NUM_LAYERS = 3; /**< Number of layers in a PXPACK file */
@@ -40,39 +68,237 @@ namespace fdl {
                  */
                 static constexpr int NUM_UNKNOWN_ENTITY_BYTES = 2;
                 
+                /**
+                 * Ways in which loadMap() can read a PXPACK file.
+                 */
+                enum loadMode {
+                    LOAD_STREAM, /**< Read the file through an std::fstream */
+                    LOAD_MAPPED, /**< Map the file into memory and parse the mapped bytes directly */
+                    /**
+                     * Same as LOAD_MAPPED, but tile layers point into the mapping
+                     * instead of copying their tiles (see tileLayer::mapTiles())
+                     */
+                    LOAD_MAPPED_ZERO_COPY,
+                    /**
+                     * Map the file and parse only the head right away; tile layers
+                     * and entities are parsed the first time they're asked for
+                     * (see getTileLayers() and getEntities())
+                     */
+                    LOAD_LAZY
+                };
+                
+            private:
+                //tiles are allocated from their map's arena (see useArena()), or the heap for standalone layers
+                typedef fdl::containerUtil::arenaAllocator <uint8_t> tileAllocator;
+                
+            public:
                 //INTERIOR CLASSES
                 
                 class tileLayer {
+                    friend class pxPack;
+                    friend class fdl::keroBlaster::tileLayerHistory;
+                    friend class fdl::keroBlaster::collisionLayer;
+                    friend struct fdl::containerUtil::tileGridTraits <tileLayer>;
+                    
                     private:
                         uint16_t width, height;
                         uint8_t flag; //Potentially has no purpose but doesn't hurt to at least record it anyway
-                        std::vector <uint8_t> tiles;
+                        std::vector <uint8_t, tileAllocator> tiles;
+                        
+                        //when the layer is mapped, its tiles are read from mappedTiles instead of tiles
+                        const uint8_t* mappedTiles;
+                        std::shared_ptr <const fdl::fileUtil::mappedFile> mapping;
+                        
+                        collisionLayer* collision; //attached collision layer, if any
                         
                     public:
                         tileLayer();
                         
+                        /**
+                         * Copies the tiles of another layer. Any
+                         * collisionLayer attached to it isn't attached to the copy.
+                         */
+                        tileLayer(const tileLayer& other);
+                        tileLayer& operator=(const tileLayer& other);
+                        
+                        /**
+                         * Moves the tiles of another layer, leaving it empty. Any
+                         * collisionLayer attached to it stays attached to it.
+                         */
+                        tileLayer(tileLayer&& other);
+                        tileLayer& operator=(tileLayer&& other);
+                        
+                        /**
+                         * Detaches any attached collisionLayer.
+                         */
+                        ~tileLayer();
+                        
                         uint16_t getWidth() const;
                         uint16_t getHeight() const;
                         uint8_t getFlag() const;
                         std::vector <uint8_t> getTiles() const;
                         
+                        /**
+                         * Returns the tile at the given coordinates. An
+                         * std::out_of_range exception is thrown if the
+                         * coordinates are outside the layer.
+                         */
+                        uint8_t getTile(const uint16_t x, const uint16_t y) const;
+                        
+                        /**
+                         * @brief Views all of the layer's tiles without copying them.
+                         *
+                         * The tiles are stored row by row. The view is invalidated
+                         * by any call that changes the layer's dimensions or, for a
+                         * mapped layer, by the first call that modifies its tiles.
+                         *
+                         * @return A read-only view of every tile in the layer.
+                         */
+                        fdl::containerUtil::arrayView <const uint8_t> getTileView() const;
+                        
+                        /**
+                         * Views a single row of the layer's tiles without
+                         * copying them. The view is invalidated the same way
+                         * as getTileView()'s. An std::out_of_range exception
+                         * is thrown if y is outside the layer.
+                         *
+                         * @param y The row to view.
+                         *
+                         * @return A read-only view of the width tiles in row y.
+                         */
+                        fdl::containerUtil::arrayView <const uint8_t> getRowView(const uint16_t y) const;
+                        
+                        /**
+                         * @return True if the layer's tiles currently point
+                         *         into a mapped file rather than being owned
+                         *         by the layer, false otherwise.
+                         */
+                        bool isMapped() const;
+                        
                         void reset();
                         
                         void setDimensions(const uint16_t width, const uint16_t height);
                         void setFlag(const uint8_t flag);
                         void setTile(const uint16_t x, const uint16_t y, const uint8_t tile);
+                        
+                        /**
+                         * @brief Replaces every tile in the layer at once.
+                         *
+                         * Sets the layer's dimensions and copies all of its
+                         * tiles from the given buffer in a single block rather
+                         * than one setTile() call per tile.
+                         *
+                         * @param width The new width of the layer.
+                         * @param height The new height of the layer.
+                         * @param tiles Pointer to width * height tiles stored
+                         *              row by row.
+                         */
+                        void setTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles);
+                        
+                        /**
+                         * @brief Points the layer at tiles inside a mapped file.
+                         *
+                         * Sets the layer's dimensions and makes it read its
+                         * tiles straight out of the given mapping instead of
+                         * copying them. The layer keeps the mapping alive for
+                         * as long as it refers to it. The first call that
+                         * modifies the layer's tiles or dimensions copies the
+                         * tiles into the layer and releases the mapping.
+                         *
+                         * @param width The width of the layer.
+                         * @param height The height of the layer.
+                         * @param tiles Pointer to the first of width * height
+                         *              tiles, stored row by row inside mapping.
+                         * @param mapping The mapped file that tiles points into.
+                         */
+                        void mapTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles,
+                                      std::shared_ptr <const fdl::fileUtil::mappedFile> mapping);
+                        
+                        //BULK OPERATIONS (vectorized where the CPU allows; see fdl/containerUtil/byteKernels.hpp)
+                        //These wrap the generic ones in fdl/containerUtil/tileGrid.hpp, which work on any tile grid
+                        
+                        /**
+                         * Sets every tile in a rectangle of the layer. An
+                         * std::out_of_range exception is thrown if the
+                         * rectangle extends outside the layer.
+                         *
+                         * @param x Left edge of the rectangle.
+                         * @param y Top edge of the rectangle.
+                         * @param width Width of the rectangle.
+                         * @param height Height of the rectangle.
+                         * @param tile The tile to fill the rectangle with.
+                         */
+                        void fillRect(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                      const uint8_t tile);
+                        
+                        /**
+                         * Replaces every occurrence of one tile in the layer with another.
+                         *
+                         * @return The number of tiles replaced.
+                         */
+                        size_t replaceTile(const uint8_t from, const uint8_t to);
+                        
+                        /**
+                         * @return The number of times each tile appears in
+                         *         the layer, indexed by tile value.
+                         */
+                        std::array <size_t, 256> getHistogram() const;
+                        
+                        /**
+                         * Counts the tiles that differ between this layer and
+                         * another. An std::invalid_argument exception is thrown
+                         * if the layers' dimensions differ.
+                         *
+                         * @return The number of coordinates at which the
+                         *         layers hold different tiles.
+                         */
+                        size_t countDifferences(const tileLayer& other) const;
+                        
+                        /**
+                         * @brief Copies a layer, replacing its tiles through a lookup table.
+                         *
+                         * Sets this layer's dimensions and flag to source's and
+                         * each of its tiles to table[tile] for the tile at the
+                         * same coordinates in source. source may be this layer.
+                         *
+                         * @param source The layer to copy.
+                         * @param table The tile that each tile value is replaced with.
+                         */
+                        void remapTiles(const tileLayer& source, const std::array <uint8_t, 256>& table);
+                        
+                    private:
+                        /**
+                         * Creates an empty layer whose tiles will be allocated
+                         * from the given arena, or the heap if it's null.
+                         */
+                        explicit tileLayer(std::shared_ptr <fdl::containerUtil::arena> source);
+                        
+                        /**
+                         * Copies mapped tiles into the layer's own storage
+                         * and releases the mapping. Does nothing if the
+                         * layer isn't mapped.
+                         */
+                        void unmapTiles();
+                        
+                        /**
+                         * Updates the attached collisionLayer, if any, after
+                         * the tiles of the given rows were written directly.
+                         */
+                        void rowsWritten(const uint16_t firstRow, const uint16_t endRow);
                 };
                 
                 class entity {
+                    friend class pxPack;
+                    
                     public:
                         static constexpr int NAME_MAX_LEN = 15;
-                    
+                        
                     private:
                         uint8_t flag, type, unknownByte;
                         uint16_t x, y;
                         std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES> data;
                         std::string name;
-                    
+                        
                     public:
                         entity();
                         
@@ -81,8 +307,8 @@ namespace fdl {
                         uint8_t getUnknownByte() const;
                         uint16_t getX() const;
                         uint16_t getY() const;
-                        std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES> getData() const;
-                        std::string getName() const;
+                        const std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES>& getData() const;
+                        const std::string& getName() const;
                         
                         void reset();
                         
@@ -96,19 +322,193 @@ namespace fdl {
                 };
                 
             private:
-                //size of entity vector must be limited to MAX_NUM_ENTITIES (limit imposed in pxPack constructor)
-                typedef fdl::containerUtil::limitedAllocator <entity> entityVectorAllocator;
+                //size of entity vector must be limited to MAX_NUM_ENTITIES (limit imposed in useArena())
+                typedef fdl::containerUtil::arenaAllocator <entity> entityVectorAllocator;
                 
             public:
                 /**
                  * @brief A vector with limited size for storing pxPack::entity objects
                  *
                  * A vector with a custom allocator to limit the amount of
-                 * entities that can be stored to MAX_NUM_ENTITIES. Other
-                 * than that it can be used like a normal vector.
+                 * entities that can be stored to MAX_NUM_ENTITIES and to
+                 * draw its storage from its map's arena. Other than that
+                 * it can be used like a normal vector.
                  */
                 typedef std::vector <entity, entityVectorAllocator> entityVector;
                 
+                /**
+                 * @brief A structure-of-arrays store of entities
+                 *
+                 * An alternative to entityVector that keeps each entity
+                 * property in its own contiguous array and every name in
+                 * one packed character array, so scans over positions or
+                 * types only touch the bytes they need. Individual entities
+                 * are accessed through entityRef, which offers the same
+                 * getters and setters as entity, or constEntityRef, which
+                 * only offers the getters. Like entityVector, it holds
+                 * at most MAX_NUM_ENTITIES entities; an std::length_error
+                 * exception is thrown if one attempts to add too many.
+                 * An entityGrid attached to the table is kept up to date
+                 * as entities are added, moved and cleared.
+                 */
+                class entityTable {
+                    friend class fdl::keroBlaster::entityGrid;
+                    
+                    public:
+                        /**
+                         * @brief A read-only reference to one entity in an entityTable
+                         *
+                         * Offers the getters of entity, reading from the table's
+                         * arrays. A reference is invalidated if the table is
+                         * destroyed. Returned by the const accessors of the table.
+                         */
+                        class constEntityRef {
+                            friend class entityTable;
+                            
+                            protected:
+                                const entityTable* table;
+                                size_t index;
+                                
+                                constEntityRef(const entityTable* table, const size_t index);
+                                
+                            public:
+                                uint8_t getFlag() const;
+                                uint8_t getType() const;
+                                uint8_t getUnknownByte() const;
+                                uint16_t getX() const;
+                                uint16_t getY() const;
+                                const std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES>& getData() const;
+                                std::string getName() const;
+                                
+                                /**
+                                 * @return A view of the entity's name in the table,
+                                 *         which is invalidated by adding entities
+                                 *         or by renaming the entity.
+                                 */
+                                fdl::containerUtil::arrayView <const char> getNameView() const;
+                                
+                                /**
+                                 * @return A copy of the referenced entity.
+                                 */
+                                entity toEntity() const;
+                        };
+                        
+                        /**
+                         * @brief A reference to one entity in an entityTable
+                         *
+                         * Offers the same interface as entity, but reads from
+                         * and writes to the table's arrays. A reference is
+                         * invalidated if the table is destroyed.
+                         */
+                        class entityRef : public constEntityRef {
+                            friend class entityTable;
+                            
+                            private:
+                                entityTable* writableTable; //the same table, reached without going through const
+                                
+                                entityRef(entityTable* table, const size_t index);
+                                
+                            public:
+                                void setFlag(const uint8_t flag);
+                                void setType(const uint8_t type);
+                                void setUnknownByte(const uint8_t unknownByte);
+                                void setX(const uint16_t x);
+                                void setY(const uint16_t y);
+                                void setData(const size_t index, const uint8_t data);
+                                void setName(const std::string& name);
+                        };
+                        
+                    private:
+                        std::vector <uint8_t> flags;
+                        std::vector <uint8_t> types;
+                        std::vector <uint8_t> unknownBytes;
+                        std::vector <uint16_t> xs;
+                        std::vector <uint16_t> ys;
+                        std::vector <std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES>> data;
+                        
+                        //names are short, so each gets a fixed slot in one packed array rather than its own allocation
+                        std::vector <std::array <char, entity::NAME_MAX_LEN>> names;
+                        std::vector <uint8_t> nameLengths;
+                        
+                        entityGrid* grid; //attached spatial index, if any
+                        
+                    public:
+                        entityTable();
+                        
+                        /**
+                         * Creates a table holding copies of the given entities.
+                         */
+                        explicit entityTable(const entityVector& entities);
+                        
+                        /**
+                         * Copies the entities of another table. Any
+                         * entityGrid attached to it isn't attached to the copy.
+                         */
+                        entityTable(const entityTable& other);
+                        entityTable& operator=(const entityTable& other);
+                        
+                        /**
+                         * Moves the entities of another table, leaving it empty. Any
+                         * entityGrid attached to it stays attached to it.
+                         */
+                        entityTable(entityTable&& other);
+                        entityTable& operator=(entityTable&& other);
+                        
+                        /**
+                         * Detaches any attached entityGrid.
+                         */
+                        ~entityTable();
+                        
+                        size_t size() const;
+                        bool empty() const;
+                        
+                        void clear();
+                        void reserve(const size_t count);
+                        
+                        /**
+                         * Adds a copy of the given entity to the end of the table.
+                         */
+                        void push_back(const entity& ent);
+                        
+                        /**
+                         * Replaces the table's contents with copies of the given entities.
+                         */
+                        void assign(const entityVector& entities);
+                        
+                        /**
+                         * Replaces the contents of the given vector with
+                         * copies of the entities in the table.
+                         */
+                        void copyTo(entityVector& entities) const;
+                        
+                        entityRef operator[](const size_t index);
+                        constEntityRef operator[](const size_t index) const;
+                        
+                        /**
+                         * Bounds-checked entity access. An std::out_of_range
+                         * exception is thrown if index is past the end of the table.
+                         */
+                        entityRef at(const size_t index);
+                        constEntityRef at(const size_t index) const;
+                        
+                        //Read-only views of each property of every entity, in table order
+                        
+                        fdl::containerUtil::arrayView <const uint8_t> getFlags() const;
+                        fdl::containerUtil::arrayView <const uint8_t> getTypes() const;
+                        fdl::containerUtil::arrayView <const uint8_t> getUnknownBytes() const;
+                        fdl::containerUtil::arrayView <const uint16_t> getXs() const;
+                        fdl::containerUtil::arrayView <const uint16_t> getYs() const;
+                        fdl::containerUtil::arrayView <const std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES>> getData() const;
+                        
+                    private:
+                        void setName(const size_t index, const std::string& name);
+                        
+                        /**
+                         * Moves an entity, updating the attached entityGrid.
+                         */
+                        void setPosition(const size_t index, const uint16_t x, const uint16_t y);
+                };
+                
             private:    
                 //PXPACK HEAD PROPERTIES
                 
@@ -129,8 +529,32 @@ namespace fdl {
                 std::string spritesheetName;
                 std::array <std::string, NUM_REFERENCED_TILESETS> tilesetNames;
                 
+                //with a string pool set, the asset names are also interned there so maps sharing the pool can compare handles
+                std::shared_ptr <fdl::containerUtil::stringPool> namePool;
+                
+                fdl::containerUtil::stringPool::handle scriptNameHandle;
+                std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_MAPS> mapNameHandles;
+                fdl::containerUtil::stringPool::handle spritesheetNameHandle;
+                std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_TILESETS> tilesetNameHandles;
+                
+                //unknown bytes are kept as they were read so that saving doesn't lose them
+                std::array <uint8_t, NUM_UNKNOWN_HEAD_BYTES> unknownHeadBytes;
+                std::array <std::array <uint8_t, NUM_UNKNOWN_TILESET_BYTES>, NUM_REFERENCED_TILESETS> unknownTilesetBytes;
+                
+                //with LOAD_LAZY, the mapped file and where in it the tile layers and entities are, until they're parsed
+                std::shared_ptr <const fdl::fileUtil::mappedFile> lazySource;
+                size_t tileLayersOffset = 0, entitiesOffset = 0;
+                bool tileLayersPending = false, entitiesPending = false;
+                
             public:
-                std::array <tileLayer, NUM_LAYERS> tileLayers; /**< An array holding all tile layers in the PXPACK file */
+                /**
+                 * @brief An array holding all tile layers in the PXPACK file
+                 *
+                 * An array holding all tile layers in the PXPACK file. If the
+                 * file was loaded with LOAD_LAZY, the layers are blank until
+                 * getTileLayers() or finishLoading() is called.
+                 */
+                std::array <tileLayer, NUM_LAYERS> tileLayers;
                 
                 /**
                  * @brief A vector holding all the entities in the PXPACK file
@@ -139,7 +563,9 @@ namespace fdl {
                  * limited by a custom allocator to hold only up to MAX_NUM_ENTITIES
                  * entities. As such, try/catches should be used to guard against
                  * storing too many entities. An std::length_error exception will
-                 * be thrown if one attempts to add too many entities.
+                 * be thrown if one attempts to add too many entities. If the file
+                 * was loaded with LOAD_LAZY, it is empty until getEntities() or
+                 * finishLoading() is called.
                  */
                 entityVector entities;
                 
@@ -157,7 +583,7 @@ namespace fdl {
                  *
                  * @param filename Name of the PXPACK file to open.
                  */
-                pxPack(const std::string& filename);
+                pxPack(const std::string& filename, const loadMode mode = LOAD_STREAM);
                 //TODO: Add constructor for initializing values
                 
                 /**
@@ -175,19 +601,200 @@ namespace fdl {
                  * will be thrown. Errors with parsing the file will cause the
                  * object to completely reset its state to avoid data corruption.
                  * Additionally, parsing errors will cause an fdl::errorUtil::fileReadError
-                 * exception to be thrown.
+                 * exception to be thrown (an std::length_error exception if an
+                 * entity's name is too long), and failing to open the file an
+                 * fdl::errorUtil::fileOpenError exception. This is a wrapper
+                 * around tryLoadMap(), which returns errors instead.
+                 *
+                 * With LOAD_LAZY, only the head is parsed (and the layer
+                 * headers checked) right away. The file stays mapped until
+                 * its tile layers and entities are parsed on first access
+                 * through getTileLayers(), getEntities() or finishLoading(),
+                 * which makes scanning many maps for their metadata cheap.
+                 * Until then, save() finishes loading first, while
+                 * getFileSize(), saveToBuffer() and getEntityView() throw an
+                 * std::logic_error exception. A lazily loaded map must not be
+                 * accessed from several threads until it has finished loading.
+                 *
+                 * With LOAD_MAPPED or LOAD_MAPPED_ZERO_COPY the file is
+                 * mapped into memory and parsed without going through
+                 * any stream. With LOAD_MAPPED_ZERO_COPY, tile layers also
+                 * keep pointing into the mapping (see tileLayer::mapTiles()),
+                 * which saves copying and memory for maps that are only read.
                  *
                  * @param filename Name of the PXPACK file to open.
+                 * @param mode How the file is read.
                  */
-                void loadMap(const std::string& filename);
+                void loadMap(const std::string& filename, const loadMode mode = LOAD_STREAM);
                 
-                std::string getFilename() const;
+                /**
+                 * @brief Parses a PXPACK file held in memory
+                 *
+                 * Parses a PXPACK file from a buffer owned by the caller
+                 * the same way loadMap() parses one from disk, but without
+                 * touching the filesystem: fdl::keroBlaster::basePath and
+                 * fdl::keroBlaster::resourceFolder aren't needed, and nothing
+                 * is ever written. The map is left without a filename, and
+                 * its tiles are copied, so the buffer can be freed afterwards.
+                 *
+                 * Errors with parsing the buffer will cause the object to
+                 * completely reset its state and an exception to be thrown,
+                 * as in loadMap().
+                 *
+                 * @param data Pointer to the first byte of the PXPACK file.
+                 * @param size Size of the PXPACK file in bytes.
+                 */
+                void loadFromMemory(const uint8_t* data, const size_t size);
                 
-                std::string getDescription () const;
-                std::string getScriptName() const;
-                std::array <std::string, NUM_REFERENCED_MAPS> getMapNames() const;
-                std::string getSpritesheetName() const;
-                std::array <std::string, NUM_REFERENCED_MAPS> getTilesetNames() const;
+                /**
+                 * Equivalent to loadFromMemory(data.data(), data.size()).
+                 *
+                 * @param data A buffer holding a PXPACK file.
+                 */
+                void loadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * @brief Parses a PXPACK file, returning errors instead of throwing them
+                 *
+                 * Loads a PXPACK file exactly as loadMap() does, except that
+                 * problems with the file itself (failing to open or read it,
+                 * or it being malformed) are returned rather than thrown, and
+                 * returning them never allocates. That makes sweeping many
+                 * files that are expected to fail, such as user-submitted
+                 * maps, much cheaper. The object is reset on any error.
+                 * Misuse is still thrown as in loadMap(): not setting
+                 * fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder,
+                 * filenames that are too long, and failing to write a dummy file.
+                 * With LOAD_LAZY, errors in the parts parsed later are thrown
+                 * when they're parsed, as before.
+                 *
+                 * @param filename Name of the PXPACK file to open.
+                 * @param mode How the file is read.
+                 *
+                 * @return The result of loading the file, whose error (if any)
+                 *         carries the byte offset at which it was found and
+                 *         the index of the tile layer or entity being parsed.
+                 *         getLoadErrorMessage() turns it into the message
+                 *         loadMap() would have thrown.
+                 */
+                fdl::errorUtil::result tryLoadMap(const std::string& filename, const loadMode mode = LOAD_STREAM);
+                
+                /**
+                 * Parses a PXPACK file held in memory as loadFromMemory()
+                 * does, returning errors as tryLoadMap() does. It never throws
+                 * on malformed data.
+                 */
+                fdl::errorUtil::result tryLoadFromMemory(const uint8_t* data, const size_t size);
+                fdl::errorUtil::result tryLoadFromMemory(const std::vector <uint8_t>& data);
+                
+                /**
+                 * @return The message describing a failed result from loading
+                 *         the PXPACK file with the given name, as thrown by
+                 *         loadMap().
+                 */
+                static std::string getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename);
+                
+                /**
+                 * @return False if the map was loaded with LOAD_LAZY and its
+                 *         tile layers or entities haven't been parsed yet,
+                 *         true otherwise.
+                 */
+                bool isFullyLoaded() const;
+                
+                /**
+                 * Parses whatever a LOAD_LAZY load left for later. Does
+                 * nothing if the map is already fully loaded. Parsing
+                 * errors reset the object and throw an
+                 * fdl::errorUtil::fileReadError exception, as in loadMap().
+                 */
+                void finishLoading();
+                
+                /**
+                 * Returns tileLayers, parsing them first if the map
+                 * was loaded with LOAD_LAZY and they haven't been yet.
+                 * Parsing errors are handled as in finishLoading().
+                 *
+                 * @return The map's tile layers.
+                 */
+                std::array <tileLayer, NUM_LAYERS>& getTileLayers();
+                
+                /**
+                 * Returns entities, parsing them first if the map
+                 * was loaded with LOAD_LAZY and they haven't been yet.
+                 * Parsing errors are handled as in finishLoading().
+                 *
+                 * @return The map's entities.
+                 */
+                entityVector& getEntities();
+                
+                /**
+                 * @brief Writes the PXPACK file.
+                 *
+                 * Serializes the map with saveToBuffer() and writes it
+                 * to the PXPACK file named by getFilename() with a single
+                 * write to a temporary file that then atomically replaces
+                 * the real one, so a failed save never leaves a partially
+                 * written map behind. If the filename was changed since the
+                 * map was loaded, the file with the original name is removed.
+                 * fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder
+                 * must be set prior to using this function, and the map must
+                 * have a filename, or an std::logic_error exception will be
+                 * thrown. Errors with writing the file will cause an
+                 * fdl::errorUtil::fileWriteError exception to be thrown.
+                 */
+                void save();
+                
+                /**
+                 * @return The exact size in bytes of the PXPACK file
+                 *         that saving the map would produce.
+                 */
+                size_t getFileSize() const;
+                
+                /**
+                 * Serializes the map into the given buffer, which must
+                 * have room for at least getFileSize() bytes.
+                 *
+                 * @param buffer The buffer the PXPACK file is written to.
+                 */
+                void saveToBuffer(uint8_t* buffer) const;
+                
+                /**
+                 * @return A buffer holding the map serialized as a
+                 *         PXPACK file.
+                 */
+                std::vector <uint8_t> saveToBuffer() const;
+                
+                const std::string& getFilename() const;
+                
+                const std::string& getDescription () const;
+                const std::string& getScriptName() const;
+                const std::array <std::string, NUM_REFERENCED_MAPS>& getMapNames() const;
+                const std::string& getMapName(const size_t index) const;
+                const std::string& getSpritesheetName() const;
+                const std::array <std::string, NUM_REFERENCED_TILESETS>& getTilesetNames() const;
+                const std::string& getTilesetName(const size_t index) const;
+                
+                /**
+                 * Handles of the asset names in the map's string pool. Maps
+                 * sharing a pool can compare and hash these instead of the names.
+                 * An std::logic_error exception is thrown if the map has no pool.
+                 */
+                fdl::containerUtil::stringPool::handle getScriptNameHandle() const;
+                const std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_MAPS>& getMapNameHandles() const;
+                fdl::containerUtil::stringPool::handle getSpritesheetNameHandle() const;
+                const std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_TILESETS>& getTilesetNameHandles() const;
+                
+                /**
+                 * @return The pool the map's asset names are interned in,
+                 *         or nullptr if setStringPool() hasn't given it one.
+                 */
+                const std::shared_ptr <fdl::containerUtil::stringPool>& getStringPool() const;
+                
+                /**
+                 * @return A read-only view of every entity in the map,
+                 *         which is invalidated whenever entities is resized.
+                 */
+                fdl::containerUtil::arrayView <const entity> getEntityView() const;
                 
                 /**
                   * Clears all values and properties held by the pxPack object.
@@ -195,6 +802,13 @@ namespace fdl {
                   */
                 void reset();
                 
+                /**
+                 * @return The path of the folder holding all PXPACK files,
+                 *         built from fdl::keroBlaster::basePath and
+                 *         fdl::keroBlaster::resourceFolder.
+                 */
+                static std::string getFolderPath();
+                
                 void setFilename(std::string filename);
                 
                 void setDescription(const std::string& description);
@@ -203,18 +817,87 @@ namespace fdl {
                 void setSpritesheetName(std::string spritesheetName);
                 void setTilesetName(const size_t index, std::string tilesetName);
                 
+                /**
+                 * @brief Interns the map's asset names in the given pool.
+                 *
+                 * Maps don't intern their asset names unless given a pool.
+                 * Once given one, the map interns its current names there,
+                 * along with the names of every file it loads (once the
+                 * whole file has been read) and every name it's given,
+                 * so a group of maps sharing a pool can compare handles.
+                 * The pool is freed with the last map using it. Handles
+                 * previously returned by the map refer to the old pool.
+                 *
+                 * @param pool The pool to use, or nullptr to stop interning.
+                 */
+                void setStringPool(std::shared_ptr <fdl::containerUtil::stringPool> pool);
+                
             private:
                 /**
-                 * @brief Opens a PXPACK file.
+                 * @brief The layout of a PXPACK file.
                  *
-                 * Opens a PXPACK file for reading and writing. If the file
-                 * does not exist, a dummy PXPACK file with blank values is
-                 * created.
+                 * Compile-time schemas (see fdl::fileUtil::schema) for
+                 * every part of a PXPACK file but the tiles themselves,
+                 * shared by the methods that read, write and measure
+                 * files so they can't disagree. Defined in pxPack.cpp.
+                 */
+                struct fileLayout;
+                
+                /**
+                 * @brief Finds the path to a PXPACK file.
+                 *
+                 * Sets the filename and returns the full path to the
+                 * given PXPACK file. If the file does not exist, a dummy
+                 * PXPACK file with blank values is created.
+                 *
+                 * @param filename Name of the PXPACK file.
                  *
-                 * @param filename Name of the PXPACK file that will be opened
-                 *                 for read and write access.
+                 * @return The path to the PXPACK file.
+                 */
+                std::string preparePath(std::string filename);
+                
+                /**
+                 * Parses a whole PXPACK file from the given reader,
+                 * resetting the object if it fails. If mapping isn't
+                 * null, tile layers point into it instead of copying
+                 * their tiles.
                  */
-                std::fstream open(std::string filename);
+                fdl::errorUtil::result parse(fdl::fileUtil::binaryReader& file, const std::shared_ptr <const fdl::fileUtil::mappedFile>& mapping);
+                
+                /**
+                 * @brief Gives the map a fresh arena.
+                 *
+                 * Empties the tile layers and entities and has them
+                 * allocate from a new arena from then on, so a loaded
+                 * map takes a few large allocations and all of them
+                 * are freed at once when the map is reloaded, reset or
+                 * destroyed.
+                 *
+                 * @param initialSize Size in bytes of the arena's first
+                 *                    block, or 0 to allocate from the
+                 *                    heap instead of an arena.
+                 */
+                void useArena(const size_t initialSize);
+                
+                /**
+                 * Empties the tile layers and has them allocate from the
+                 * given arena, or the heap if it's null. Used when lazily
+                 * loaded layers are read.
+                 */
+                void useTileArena(const std::shared_ptr <fdl::containerUtil::arena>& source);
+                
+                /**
+                 * Empties the entities and has them allocate from the given
+                 * arena, or the heap if it's null. Used when lazily loaded
+                 * entities are read.
+                 */
+                void useEntityArena(const std::shared_ptr <fdl::containerUtil::arena>& source);
+                
+                /**
+                 * @return An arena whose first block holds initialSize
+                 *         bytes, or nullptr if initialSize is 0.
+                 */
+                static std::shared_ptr <fdl::containerUtil::arena> makeArena(const size_t initialSize);
                 
                 /**
                  * @brief Reads the head.
@@ -225,10 +908,9 @@ namespace fdl {
                  *
                  * @param file The PXPACK file to read the head from.
                  *
-                 * @return True if there were no issues parsing the head,
-                 *         false otherwise.
+                 * @return The result of parsing the head.
                  */
-                void readHead(std::fstream& file);
+                fdl::errorUtil::result readHead(fdl::fileUtil::binaryReader& file);
                 
                 /**
                  * @brief Reads tile layers.
@@ -238,42 +920,114 @@ namespace fdl {
                  * the method fails.
                  *
                  * @param file The PXPACK file to read the tile layers from.
+                 * @param mapping If not null, the mapping that file reads
+                 *                from, which tile layers will point into.
                  *
-                 * @return True if there were no issues parsing the tile
-                 *         layers, false otherwise.
+                 * @return The result of parsing the tile layers.
                  */
-                void readTileLayers(std::fstream& file);
+                fdl::errorUtil::result readTileLayers(fdl::fileUtil::binaryReader& file, const std::shared_ptr <const fdl::fileUtil::mappedFile>& mapping);
                 
                 /**
-                 * @brief Reads entities.
+                 * @brief Skips tile layers.
                  *
-                 * Reads all the entities from the given PXPACK file.
+                 * Moves past all the tile layers in the given PXPACK file
+                 * without storing them, checking their headers and that
+                 * their tiles fit in the file.
                  *
-                 * @param file The PXPACK file to read the entities from.
+                 * @param file The PXPACK file whose tile layers will be skipped.
                  *
-                 * @return True if there were no issues parsing the
-                 *         entities, false otherwise.
+                 * @return The result of skipping the tile layers.
                  */
-                void readEntities(std::fstream& file);
+                fdl::errorUtil::result skipTileLayers(fdl::fileUtil::binaryReader& file);
                 
                 /**
-                 * @brief Reads the PXPACK header.
-                 *
-                 * Reads the 16-byte header at the top of the PXPACK
-                 * file provided.
+                 * Reads the header and dimensions at the start of the
+                 * tile layer with the given index, failing if the header
+                 * is incorrect.
+                 */
+                fdl::errorUtil::result readLayerHead(fdl::fileUtil::binaryReader& file, const int index, uint16_t& width, uint16_t& height);
+                
+                /**
+                 * Parses the tile layers or entities that a LOAD_LAZY
+                 * load left for later, if there are any.
+                 */
+                void loadPendingTileLayers();
+                void loadPendingEntities();
+                
+                /**
+                 * Throws an std::logic_error exception naming the
+                 * given method if the map hasn't finished loading.
+                 */
+                void checkFullyLoaded(const std::string& method) const;
+                
+                /**
+                 * Throws an std::logic_error exception naming the given
+                 * method if the map hasn't been given a string pool.
+                 */
+                void checkStringPool(const std::string& method) const;
+                
+                /**
+                 * Interns the asset names in the string pool, if there
+                 * is one, once a file has been read.
                  *
-                 * @return The header string, which can be compared
-                 *         to an exact string value to ensure the
-                 *         validity of the PXPACK file.
+                 * @param offset Offset to report if the pool is full.
                  */
-                std::string readHeader(std::fstream& file);
+                fdl::errorUtil::result internNames(const size_t offset);
                 
                 /**
-                 * Reads a string from a PXPACK file.
+                 * @return The handle of the given name in the string pool,
+                 *         or stringPool::EMPTY if there's no pool.
+                 */
+                fdl::containerUtil::stringPool::handle internName(const std::string& name);
+                
+                /**
+                 * Throws the exception that loadMap() throws for the
+                 * given failed result from loading the named file.
+                 */
+                [[noreturn]] static void throwLoadError(const fdl::errorUtil::result& result, const std::string& filename);
+                
+                /**
+                 * @brief Reads entities.
                  *
-                 * @return The string that was read.
+                 * Reads all the entities from the given PXPACK file.
+                 *
+                 * @param file The PXPACK file to read the entities from.
+                 *
+                 * @return The result of parsing the entities.
                  */
-                std::string readString(std::fstream& file);
+                fdl::errorUtil::result readEntities(fdl::fileUtil::binaryReader& file);
+        };
+    }
+    
+    namespace containerUtil {
+        template <>
+        struct tileGridTraits <fdl::keroBlaster::pxPack::tileLayer> {
+            static size_t getWidth(const fdl::keroBlaster::pxPack::tileLayer& layer) {
+                return layer.width;
+            }
+            
+            static size_t getHeight(const fdl::keroBlaster::pxPack::tileLayer& layer) {
+                return layer.height;
+            }
+            
+            static const uint8_t* getTiles(const fdl::keroBlaster::pxPack::tileLayer& layer) {
+                return (layer.isMapped() ? layer.mappedTiles : layer.tiles.data());
+            }
+            
+            //mapped tiles are copied into the layer before they're written to
+            static uint8_t* getWritableTiles(fdl::keroBlaster::pxPack::tileLayer& layer) {
+                layer.unmapTiles();
+                return layer.tiles.data();
+            }
+            
+            //keeps an attached collision layer in step with writes made by the tile grid algorithms
+            static void tilesWritten(fdl::keroBlaster::pxPack::tileLayer& layer, const size_t firstRow, const size_t endRow) {
+                layer.rowsWritten(firstRow, endRow);
+            }
+            
+            static const char* getName() {
+                return "tile layer";
+            }
         };
     }
 }
@@ -0,0 +1,79 @@
+#ifndef PXPACKBATCH_HPP
+#define PXPACKBATCH_HPP
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * Describes a PXPACK file that failed to load
+         * as part of a batch.
+         */
+        struct pxPackLoadError {
+            std::string filename; /**< Name of the PXPACK file, as it was given to the batch */
+            std::string message; /**< Message describing the error, as pxPack::loadMap() would have thrown it */
+            fdl::errorUtil::errorCode code; /**< What went wrong with the file, or SUCCESS if loading threw an exception instead */
+            uint64_t offset; /**< Byte offset in the file at which the error was found */
+        };
+        
+        /**
+         * @brief The outcome of loading a batch of PXPACK files.
+         *
+         * Maps are stored in the order their files were given,
+         * with any that failed to load left out and recorded
+         * in errors instead.
+         */
+        struct pxPackBatch {
+            std::vector <pxPack> maps;
+            std::vector <pxPackLoadError> errors;
+        };
+        
+        /**
+         * @brief Loads many PXPACK files concurrently.
+         *
+         * Loads each of the given PXPACK files with pxPack::tryLoadMap()
+         * on a pool of worker threads, so malformed files cost no more
+         * than valid ones. A file failing to load doesn't stop the
+         * others; its error is recorded in the result instead of being
+         * thrown. fdl::keroBlaster::basePath and
+         * fdl::keroBlaster::resourceFolder must be set prior to using
+         * this function, or an std::logic_error exception will be thrown.
+         *
+         * @param filenames Names of the PXPACK files to load.
+         * @param mode How each file is read.
+         * @param maxThreads Most worker threads to use, or 0 to use
+         *                   one per hardware thread.
+         *
+         * @return The loaded maps and the errors of those that failed.
+         */
+        pxPackBatch loadPxPacks(const std::vector <std::string>& filenames,
+                                const pxPack::loadMode mode = pxPack::LOAD_STREAM,
+                                unsigned int maxThreads = 0);
+        
+        /**
+         * @brief Loads every PXPACK file in the field folder concurrently.
+         *
+         * Lists every PXPACK file in the field folder of
+         * fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder
+         * and loads them with loadPxPacks(). An fdl::errorUtil::fileOpenError
+         * exception is thrown if the folder cannot be listed.
+         *
+         * @param mode How each file is read.
+         * @param maxThreads Most worker threads to use, or 0 to use
+         *                   one per hardware thread.
+         *
+         * @return The loaded maps and the errors of those that failed.
+         */
+        pxPackBatch loadFieldFolder(const pxPack::loadMode mode = pxPack::LOAD_STREAM,
+                                    unsigned int maxThreads = 0);
+    }
+}
+
+#endif //PXPACKBATCH_HPP
\ No newline at end of file
@@ -0,0 +1,167 @@
+#ifndef PXPACKCACHE_HPP
+#define PXPACKCACHE_HPP
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+
+#include <mutex>
+#include <future>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        
+        /**
+         * @brief A thread-safe cache of loaded PXPACK files.
+         *
+         * Class that hands out shared, immutable pxPack objects
+         * keyed by base filename so that maps requested repeatedly
+         * are only read and parsed once. A cached map is reloaded
+         * if its file's size or modification time has changed since
+         * it was loaded. Once the estimated memory used by cached maps
+         * exceeds the memory budget, the least recently used maps are
+         * evicted (maps still held by callers stay alive until released).
+         * All methods may be called from any number of threads at once;
+         * threads asking for the same map while it's being loaded wait
+         * for that load rather than loading it again.
+         */
+        class pxPackCache {
+            public:
+                /**
+                 * Counters describing how the cache has been used,
+                 * for tuning its memory budget.
+                 */
+                struct stats {
+                    uint64_t hits = 0; /**< Requests served from the cache or by waiting for another thread's load */
+                    uint64_t misses = 0; /**< Requests that had to load the map (including reloads) */
+                    uint64_t evictions = 0; /**< Maps dropped to stay within the memory budget */
+                    uint64_t invalidations = 0; /**< Cached maps dropped because their file changed */
+                };
+                
+            private:
+                struct entry {
+                    std::string key;
+                    std::shared_ptr <const pxPack> map;
+                    fdl::fileUtil::fileStatus status;
+                    size_t memoryUsage;
+                };
+                
+                //a load in progress, which other threads wanting the same file can wait for
+                struct pendingLoad {
+                    fdl::fileUtil::fileStatus status;
+                    std::shared_future <std::shared_ptr <const pxPack>> result;
+                    const void* owner; //identifies the thread's load, so it only ever clears its own entry
+                };
+                
+                mutable std::mutex mutex;
+                
+                //most recently used maps are at the front
+                std::list <entry> entries;
+                std::unordered_map <std::string, std::list <entry>::iterator> index;
+                std::unordered_map <std::string, pendingLoad> pending;
+                
+                size_t memoryBudget;
+                size_t memoryUsage;
+                pxPack::loadMode mode;
+                stats counters;
+                
+            public:
+                /**
+                 * Creates an empty cache. An std::invalid_argument
+                 * exception is thrown if mode is pxPack::LOAD_LAZY,
+                 * since lazily loaded maps can't be shared between threads.
+                 *
+                 * @param memoryBudget Most memory (in bytes) that cached
+                 *                     maps should use.
+                 * @param mode How maps are loaded into the cache.
+                 */
+                explicit pxPackCache(const size_t memoryBudget, const pxPack::loadMode mode = pxPack::LOAD_STREAM);
+                
+                /**
+                 * @brief Gets a map from the cache.
+                 *
+                 * Returns the cached map with the given name, loading
+                 * it with pxPack::loadMap() first if it isn't cached or
+                 * its file has changed. Errors from loading are thrown
+                 * just as pxPack::loadMap() throws them, including to
+                 * every thread that was waiting for the failed load.
+                 *
+                 * @param filename Name of the PXPACK file; any path and
+                 *                 extension are ignored.
+                 *
+                 * @return A shared, read-only instance of the map.
+                 */
+                std::shared_ptr <const pxPack> get(const std::string& filename);
+                
+                /**
+                 * Drops the map with the given name from the
+                 * cache, if it's there.
+                 */
+                void erase(const std::string& filename);
+                
+                /**
+                 * Drops every map from the cache. Counters are kept.
+                 */
+                void clear();
+                
+                /**
+                 * Changes the memory budget, evicting maps right
+                 * away if they no longer fit.
+                 */
+                void setMemoryBudget(const size_t memoryBudget);
+                
+                size_t getMemoryBudget() const;
+                
+                /**
+                 * @return The estimated memory, in bytes, used by
+                 *         all maps in the cache.
+                 */
+                size_t getMemoryUsage() const;
+                
+                size_t getSize() const;
+                
+                stats getStats() const;
+                
+            private:
+                /**
+                 * Evicts least recently used maps until the cache
+                 * fits its memory budget, always keeping the most
+                 * recently used one. The mutex must be held.
+                 */
+                void evict();
+                
+                /**
+                 * Removes the given entry. The mutex must be held.
+                 */
+                void remove(const std::list <entry>::iterator it);
+                
+                /**
+                 * Caches a freshly loaded map unless a newer version of
+                 * it was cached by another thread in the meantime. The
+                 * mutex must be held.
+                 */
+                void insert(const std::string& key, const std::shared_ptr <const pxPack>& map,
+                            const fdl::fileUtil::fileStatus& status);
+                
+                /**
+                 * Forgets the pending load of the given map if it's
+                 * the one with the given owner. The mutex must be held.
+                 */
+                void finishPending(const std::string& key, const void* owner);
+                
+                /**
+                 * @return An estimate of the memory used by the given map.
+                 */
+                static size_t estimateMemoryUsage(const pxPack& map);
+        };
+    }
+}
+
+#endif //PXPACKCACHE_HPP
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef TILELAYERHISTORY_HPP
+#define TILELAYERHISTORY_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        /**
+         * @brief Undo/redo history for a tile layer
+         *
+         * Records versions of a tile layer as lists of fixed-size chunks
+         * of tiles. A chunk that's unchanged from the previous version is
+         * shared with it rather than copied, so each version only costs
+         * memory for the chunks its edits touched. Each version also keeps
+         * a journal of which chunks changed. Committing compares the layer
+         * against the current version chunk by chunk, which is a fast
+         * memcmp pass over the tiles. Undoing and redoing between versions
+         * of the same size only copy back the chunks the two versions
+         * don't share; restore() copies every chunk back into the layer.
+         */
+        class tileLayerHistory {
+            public:
+                static constexpr size_t CHUNK_SIZE = 4096; /**< Number of consecutive tiles (in row-major order) per chunk */
+                
+            private:
+                typedef std::shared_ptr <const std::vector <uint8_t>> chunkPtr;
+                
+                struct version {
+                    uint16_t width;
+                    uint16_t height;
+                    uint8_t flag;
+                    std::vector <chunkPtr> chunks;
+                    std::vector <size_t> changedChunks; //indices of chunks not shared with the previous version
+                };
+                
+                std::deque <version> versions;
+                size_t current;
+                size_t maxVersions;
+                
+            public:
+                /**
+                 * Starts a history whose only version is the given layer.
+                 *
+                 * @param maxVersions Most versions to keep, or 0 for no
+                 *                    limit. Once exceeded, the oldest
+                 *                    versions are dropped.
+                 */
+                explicit tileLayerHistory(const pxPack::tileLayer& layer, const size_t maxVersions = 0);
+                
+                /**
+                 * Records the layer's current state as a new version after
+                 * the current one. Any versions that had been undone are
+                 * dropped. Nothing is recorded if the layer is unchanged.
+                 *
+                 * @return Whether a new version was recorded.
+                 */
+                bool commit(const pxPack::tileLayer& layer);
+                
+                bool canUndo() const;
+                bool canRedo() const;
+                
+                /**
+                 * Steps back to the previous version and restores it into
+                 * the given layer, which should hold the current version
+                 * (changes that haven't been committed may survive). An
+                 * std::logic_error exception is thrown if there's no
+                 * version to step back to.
+                 */
+                void undo(pxPack::tileLayer& layer);
+                
+                /**
+                 * Steps forward to the next version and restores it into
+                 * the given layer, which should hold the current version
+                 * (changes that haven't been committed may survive). An
+                 * std::logic_error exception is thrown if there's no
+                 * version to step forward to.
+                 */
+                void redo(pxPack::tileLayer& layer);
+                
+                /**
+                 * Restores the current version into the given layer,
+                 * discarding any changes made since it was committed.
+                 */
+                void restore(pxPack::tileLayer& layer) const;
+                
+                size_t getNumVersions() const;
+                size_t getCurrentVersion() const;
+                
+                /**
+                 * @return The chunks that the given version changed from
+                 *         the one before it (every chunk, for the oldest
+                 *         version kept). An std::out_of_range exception
+                 *         is thrown if there's no such version.
+                 */
+                const std::vector <size_t>& getChangedChunks(const size_t index) const;
+                
+                /**
+                 * @return The number of bytes of tiles held by the
+                 *         history, counting each shared chunk once.
+                 */
+                size_t getMemoryUsage() const;
+                
+            private:
+                /**
+                 * Splits the layer into chunks, sharing those that
+                 * match the same chunk of previous.
+                 */
+                static version makeVersion(const pxPack::tileLayer& layer, const version* previous);
+                
+                /**
+                 * Restores the current version into a layer holding
+                 * previous, copying only the chunks that differ.
+                 */
+                void restoreFrom(pxPack::tileLayer& layer, const version& previous) const;
+        };
+    }
+}
+
+#endif //TILELAYERHISTORY_HPP
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <string>
+#include <vector>
+#include <array>
+
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/caveStory/pxa.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        //definition in hpp, declaration here
+        
+        constexpr char pxa::FILE_EXTENSION [];
+        
+        constexpr size_t pxa::NUM_ATTRIBUTES;
+        
+        
+        pxa::pxa() : attributes() {}
+        
+        pxa::pxa(const std::string& filename) : attributes() {
+            loadFile(filename);
+        }
+        
+        const std::array <uint8_t, pxa::NUM_ATTRIBUTES>& pxa::getAttributes() const {
+            return attributes;
+        }
+        
+        uint8_t pxa::getAttribute(const uint8_t tile) const {
+            return attributes[tile]; //a tile can't be out of range, since there's an attribute for every byte value
+        }
+        
+        void pxa::loadFile(const std::string& filename) {
+            std::vector <uint8_t> buffer;
+            const fdl::errorUtil::result RESULT = tryLoadFile(filename, buffer);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, fdl::fileUtil::stripToBaseFilename(filename, FILE_EXTENSION));
+            }
+        }
+        
+        void pxa::loadFromMemory(const uint8_t* data, const size_t size) {
+            const fdl::errorUtil::result RESULT = tryLoadFromMemory(data, size);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, "");
+            }
+        }
+        
+        void pxa::loadFromMemory(const std::vector <uint8_t>& data) {
+            loadFromMemory(data.data(), data.size());
+        }
+        
+        fdl::errorUtil::result pxa::tryLoadFile(const std::string& filename, std::vector <uint8_t>& buffer) {
+            const fdl::errorUtil::result RESULT = fdl::fileUtil::readFile(filename, buffer);
+            
+            if (!RESULT) {
+                reset();
+                return RESULT;
+            }
+            
+            return tryLoadFromMemory(buffer);
+        }
+        
+        fdl::errorUtil::result pxa::tryLoadFromMemory(const uint8_t* data, const size_t size) {
+            if (size < NUM_ATTRIBUTES) {
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADATTRIBUTES, size);
+            }
+            
+            memcpy(attributes.data(), data, NUM_ATTRIBUTES);
+            return fdl::errorUtil::result();
+        }
+        
+        fdl::errorUtil::result pxa::tryLoadFromMemory(const std::vector <uint8_t>& data) {
+            return tryLoadFromMemory(data.data(), data.size());
+        }
+        
+        std::string pxa::getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename) {
+            switch (result.getCode()) {
+                case fdl::errorUtil::FILE_OPENFAIL:
+                    return "ERROR: Failed to open PXA file " + filename + " for parsing.";
+                
+                case fdl::errorUtil::FILE_READFAIL:
+                    return "ERROR: Could not read PXA file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADATTRIBUTES:
+                    return "ERROR: PXA file " + filename + " has fewer than " + std::to_string(NUM_ATTRIBUTES) + " tile attributes.";
+                
+                default:
+                    return result.getMessage() + filename + '.';
+            }
+        }
+        
+        void pxa::reset() {
+            attributes.fill(0);
+        }
+        
+        void pxa::throwLoadError(const fdl::errorUtil::result& result, const std::string& filename) {
+            const std::string MESSAGE = getLoadErrorMessage(result, filename);
+            
+            if (fdl::errorUtil::FILE_OPENFAIL == result.getCode()) {
+                throw fdl::errorUtil::fileOpenError(MESSAGE);
+            }
+            
+            throw fdl::errorUtil::fileReadError(MESSAGE);
+        }
+    }
+}
\ No newline at end of file
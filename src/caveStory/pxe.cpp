@@ -0,0 +1,200 @@
+#include <string>
+#include <vector>
+#include <tuple>
+
+#include <stdexcept>
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/caveStory/pxe.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+#include "fdl/fileUtil/binaryReader.hpp"
+#include "fdl/fileUtil/binarySchema.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        namespace schema = fdl::fileUtil::schema;
+        
+        struct pxe::fileLayout {
+            typedef schema::record <schema::magic <HEADER, sizeof(HEADER)>> header;
+        };
+        
+        static_assert(sizeof(pxe::entity) == pxe::ENTITY_SIZE, "pxe::entity must have the same layout as an entity in a PXE file");
+        
+        //definition in hpp, declaration here
+        
+        constexpr char pxe::FILE_EXTENSION [];
+        
+        constexpr char pxe::HEADER [];
+        constexpr size_t pxe::HEAD_SIZE;
+        
+        constexpr size_t pxe::ENTITY_SIZE;
+        
+        
+        pxe::pxe() : entities() {}
+        
+        pxe::pxe(const std::string& filename) : entities() {
+            loadFile(filename);
+        }
+        
+        const std::vector <pxe::entity>& pxe::getEntities() const {
+            return entities;
+        }
+        
+        void pxe::loadFile(const std::string& filename) {
+            std::vector <uint8_t> buffer;
+            const fdl::errorUtil::result RESULT = tryLoadFile(filename, buffer);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, fdl::fileUtil::stripToBaseFilename(filename, FILE_EXTENSION));
+            }
+        }
+        
+        void pxe::loadFromMemory(const uint8_t* data, const size_t size) {
+            const fdl::errorUtil::result RESULT = tryLoadFromMemory(data, size);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, "");
+            }
+        }
+        
+        void pxe::loadFromMemory(const std::vector <uint8_t>& data) {
+            loadFromMemory(data.data(), data.size());
+        }
+        
+        fdl::errorUtil::result pxe::tryLoadFile(const std::string& filename, std::vector <uint8_t>& buffer) {
+            const fdl::errorUtil::result RESULT = fdl::fileUtil::readFile(filename, buffer);
+            
+            if (!RESULT) {
+                reset();
+                return RESULT;
+            }
+            
+            return tryLoadFromMemory(buffer);
+        }
+        
+        fdl::errorUtil::result pxe::tryLoadFromMemory(const uint8_t* data, const size_t size) {
+            fdl::fileUtil::binaryReader reader(data, size);
+            return parse(reader);
+        }
+        
+        fdl::errorUtil::result pxe::tryLoadFromMemory(const std::vector <uint8_t>& data) {
+            return tryLoadFromMemory(data.data(), data.size());
+        }
+        
+        std::string pxe::getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename) {
+            switch (result.getCode()) {
+                case fdl::errorUtil::FILE_OPENFAIL:
+                    return "ERROR: Failed to open PXE file " + filename + " for parsing.";
+                
+                case fdl::errorUtil::FILE_READFAIL:
+                    return "ERROR: Could not read PXE file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADHEADER:
+                    return "ERROR: Incorrect PXE header in file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADENTITYCOUNT:
+                    return "ERROR: Could not parse entity number of PXE file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADENTITY:
+                    return "ERROR: Could not parse entity " + std::to_string(result.getIndex() + 1) + " of PXE file " + filename + '.';
+                
+                default:
+                    return result.getMessage() + filename + '.';
+            }
+        }
+        
+        size_t pxe::getFileSize() const {
+            return HEAD_SIZE + entities.size() * ENTITY_SIZE;
+        }
+        
+        void pxe::saveToBuffer(uint8_t* buffer) const {
+            buffer = fileLayout::header::encode(buffer, std::make_tuple(true));
+            buffer = fdl::fileUtil::storeLittleEndian <uint32_t>(buffer, entities.size());
+            
+            for (const entity& ent : entities) {
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.x);
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.y);
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.flagId);
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.event);
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.type);
+                buffer = fdl::fileUtil::storeLittleEndian(buffer, ent.flags);
+            }
+        }
+        
+        std::vector <uint8_t> pxe::saveToBuffer() const {
+            std::vector <uint8_t> buffer(getFileSize());
+            saveToBuffer(buffer.data());
+            
+            return buffer;
+        }
+        
+        void pxe::reset() {
+            entities.clear();
+        }
+        
+        fdl::errorUtil::result pxe::parse(fdl::fileUtil::binaryReader& file) {
+            const size_t START = file.tell();
+            
+            bool headerMatched = false;
+            
+            if (!fileLayout::header::read(file, std::tie(headerMatched)) || !headerMatched) {
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADHEADER, START);
+            }
+            
+            const size_t COUNT_START = file.tell();
+            const uint32_t NUM_ENTITIES = file.read <uint32_t>();
+            
+            if (!file.good() || NUM_ENTITIES > INT32_MAX) { //the game reads it as a signed integer, so larger counts are negative
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADENTITYCOUNT, COUNT_START);
+            }
+            
+            const size_t AVAILABLE = file.getRemaining() / ENTITY_SIZE;
+            
+            if (NUM_ENTITIES > AVAILABLE) { //the first entity that's cut off
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADENTITY, file.tell() + AVAILABLE * ENTITY_SIZE, AVAILABLE);
+            }
+            
+            //every entity has been bounds checked, so copy them all at once
+            entities.resize(NUM_ENTITIES);
+            const uint8_t* const IN = file.skip(NUM_ENTITIES * ENTITY_SIZE);
+            
+            if (NUM_ENTITIES > 0) {
+                memcpy(entities.data(), IN, NUM_ENTITIES * ENTITY_SIZE);
+            }
+            
+            if (!fdl::fileUtil::LITTLE_ENDIAN_TARGET) { //folded away on little-endian systems
+                for (entity& ent : entities) {
+                    ent.x = fdl::fileUtil::convertLittleEndian(ent.x);
+                    ent.y = fdl::fileUtil::convertLittleEndian(ent.y);
+                    ent.flagId = fdl::fileUtil::convertLittleEndian(ent.flagId);
+                    ent.event = fdl::fileUtil::convertLittleEndian(ent.event);
+                    ent.type = fdl::fileUtil::convertLittleEndian(ent.type);
+                    ent.flags = fdl::fileUtil::convertLittleEndian(ent.flags);
+                }
+            }
+            
+            return fdl::errorUtil::result();
+        }
+        
+        void pxe::throwLoadError(const fdl::errorUtil::result& result, const std::string& filename) {
+            const std::string MESSAGE = getLoadErrorMessage(result, filename);
+            
+            if (fdl::errorUtil::FILE_OPENFAIL == result.getCode()) {
+                throw fdl::errorUtil::fileOpenError(MESSAGE);
+            }
+            
+            throw fdl::errorUtil::fileReadError(MESSAGE);
+        }
+    }
+}
\ No newline at end of file
@@ -1,11 +1,266 @@
+#include <ios>
+
 #include <string>
 #include <vector>
+#include <tuple>
+#include <memory>
+
+#include <fstream>
 
+#include <stdexcept>
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
+
+#include <cstddef>
 #include <cstdint>
 
-#include "pxm.hpp"
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/caveStory/pxm.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+#include "fdl/fileUtil/mappedFile.hpp"
+#include "fdl/fileUtil/binaryReader.hpp"
+#include "fdl/fileUtil/binarySchema.hpp"
+
+#include "fdl/containerUtil/containerUtil.hpp"
 
 namespace fdl {
     namespace caveStory {
+        namespace schema = fdl::fileUtil::schema;
+        
+        struct pxm::fileLayout {
+            //the header and dimensions are read separately so that a file cut off in its dimensions isn't reported as having the wrong header
+            typedef schema::record <schema::magic <HEADER, sizeof(HEADER)>> header;
+            typedef schema::record <schema::uint16LE, schema::uint16LE> dimensions; //width and height; the tiles that follow are copied as one block
+        };
+        
+        //definition in hpp, declaration here
+        
+        constexpr char pxm::FILE_EXTENSION [];
+        
+        constexpr char pxm::HEADER [];
+        constexpr size_t pxm::HEAD_SIZE;
+        
+        
+        pxm::pxm() : width(0), height(0), tiles() {}
+        
+        pxm::pxm(const std::string& filename, const loadMode mode) : width(0), height(0), tiles() {
+            loadMap(filename, mode);
+        }
+        
+        uint16_t pxm::getWidth() const {
+            return width;
+        }
+        
+        uint16_t pxm::getHeight() const {
+            return height;
+        }
+        
+        const std::vector <uint8_t>& pxm::getTiles() const {
+            return tiles;
+        }
+        
+        uint8_t pxm::getTile(const uint16_t x, const uint16_t y) const {
+            if (x >= width || y >= height) {
+                throw std::out_of_range("ERROR: Attempt to get tile (" + std::to_string(x) + ", " + std::to_string(y) +
+                                        ") of a " + std::to_string(width) + 'x' + std::to_string(height) + " PXM map.");
+            }
+            
+            return tiles[fdl::containerUtil::indexFromCoords(x, y, width)];
+        }
+        
+        void pxm::loadMap(const std::string& filename, const loadMode mode) {
+            const fdl::errorUtil::result RESULT = tryLoadMap(filename, mode);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, fdl::fileUtil::stripToBaseFilename(filename, FILE_EXTENSION));
+            }
+        }
+        
+        void pxm::loadFromMemory(const uint8_t* data, const size_t size) {
+            const fdl::errorUtil::result RESULT = tryLoadFromMemory(data, size);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, "");
+            }
+        }
+        
+        void pxm::loadFromMemory(const std::vector <uint8_t>& data) {
+            loadFromMemory(data.data(), data.size());
+        }
+        
+        fdl::errorUtil::result pxm::tryLoadMap(const std::string& filename, const loadMode mode) {
+            if (LOAD_STREAM == mode) {
+                std::ifstream file(filename, std::ifstream::in | std::ifstream::binary);
+                
+                if (!file) {
+                    reset();
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_OPENFAIL, 0);
+                }
+                
+                //the file's size is needed up front so that dimensions it can't hold are rejected before allocating any tiles
+                file.seekg(0, std::ios::end);
+                const std::streamoff FILE_SIZE = file.tellg();
+                file.seekg(0, std::ios::beg);
+                
+                if (FILE_SIZE < 0 || !file) {
+                    reset();
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_READFAIL, 0);
+                }
+                
+                //read the head into a small buffer, then the tiles straight into the map with a single call
+                uint8_t head [HEAD_SIZE];
+                file.read((char*)head, HEAD_SIZE);
+                
+                fdl::errorUtil::result result;
+                fdl::fileUtil::binaryReader reader(head, file.gcount());
+                
+                if (!(result = readHead(reader))) {
+                    reset();
+                    return result;
+                }
+                
+                const size_t NUM_TILES = (size_t)width * height;
+                
+                if ((uint64_t)FILE_SIZE - HEAD_SIZE < NUM_TILES) {
+                    reset();
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, HEAD_SIZE); //the offset of the tiles, as parse() reports it
+                }
+                
+                tiles.resize(NUM_TILES);
+                file.read((char*)tiles.data(), tiles.size());
+                
+                if (file.gcount() != (std::streamsize)tiles.size()) { //the file shrank after it was measured
+                    reset();
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, HEAD_SIZE);
+                }
+                
+                return result;
+            }
+            
+            const std::shared_ptr <const fdl::fileUtil::mappedFile> MAPPING = fdl::fileUtil::mappedFile::tryMap(filename);
+            
+            if (nullptr == MAPPING) {
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_OPENFAIL, 0);
+            }
+            
+            fdl::fileUtil::binaryReader reader(*MAPPING);
+            return parse(reader);
+        }
+        
+        fdl::errorUtil::result pxm::tryLoadFromMemory(const uint8_t* data, const size_t size) {
+            fdl::fileUtil::binaryReader reader(data, size);
+            return parse(reader);
+        }
+        
+        fdl::errorUtil::result pxm::tryLoadFromMemory(const std::vector <uint8_t>& data) {
+            return tryLoadFromMemory(data.data(), data.size());
+        }
+        
+        std::string pxm::getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename) {
+            switch (result.getCode()) {
+                case fdl::errorUtil::FILE_OPENFAIL:
+                    return "ERROR: Failed to open PXM file " + filename + " for parsing.";
+                
+                case fdl::errorUtil::FILE_BADHEADER:
+                    return "ERROR: Incorrect PXM header in file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADHEAD:
+                    return "ERROR: Could not parse dimensions of PXM file " + filename + '.';
+                
+                case fdl::errorUtil::FILE_BADLAYER:
+                    return "ERROR: Could not parse tiles of PXM file " + filename + '.';
+                
+                default:
+                    return result.getMessage() + filename + '.';
+            }
+        }
+        
+        size_t pxm::getFileSize() const {
+            return HEAD_SIZE + tiles.size();
+        }
+        
+        void pxm::saveToBuffer(uint8_t* buffer) const {
+            buffer = fileLayout::header::encode(buffer, std::make_tuple(true));
+            buffer = fileLayout::dimensions::encode(buffer, std::make_tuple(width, height));
+            
+            if (!tiles.empty()) {
+                memcpy(buffer, tiles.data(), tiles.size());
+            }
+        }
+        
+        std::vector <uint8_t> pxm::saveToBuffer() const {
+            std::vector <uint8_t> buffer(getFileSize());
+            saveToBuffer(buffer.data());
+            
+            return buffer;
+        }
+        
+        void pxm::reset() {
+            width = 0;
+            height = 0;
+            std::vector <uint8_t>().swap(tiles); //clear() would keep the old map's storage
+        }
+        
+        fdl::errorUtil::result pxm::readHead(fdl::fileUtil::binaryReader& file) {
+            const size_t START = file.tell();
+            
+            bool headerMatched = false;
+            
+            if (!fileLayout::header::read(file, std::tie(headerMatched)) || !headerMatched) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADHEADER, START);
+            }
+            
+            uint16_t newWidth = 0, newHeight = 0;
+            
+            if (!fileLayout::dimensions::read(file, std::tie(newWidth, newHeight))) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADHEAD, file.tell());
+            }
+            
+            width = newWidth;
+            height = newHeight;
+            
+            return fdl::errorUtil::result();
+        }
+        
+        fdl::errorUtil::result pxm::parse(fdl::fileUtil::binaryReader& file) {
+            fdl::errorUtil::result result = readHead(file);
+            
+            if (result) {
+                const size_t NUM_TILES = (size_t)width * height;
+                const uint8_t* const TILES = file.skip(NUM_TILES); //bounds check every tile at once
+                
+                if (nullptr != TILES) {
+                    tiles.assign(TILES, TILES + NUM_TILES);
+                }
+                else {
+                    result = fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, file.tell());
+                }
+            }
+            
+            /*
+             * If any problems occur with parsing the file, completely reset
+             * all properties to avoid data corruption and return the error
+             * so the caller knows parsing failed.
+             */
+            if (!result) {
+                reset();
+            }
+            
+            return result;
+        }
+        
+        void pxm::throwLoadError(const fdl::errorUtil::result& result, const std::string& filename) {
+            const std::string MESSAGE = getLoadErrorMessage(result, filename);
+            
+            if (fdl::errorUtil::FILE_OPENFAIL == result.getCode()) {
+                throw fdl::errorUtil::fileOpenError(MESSAGE);
+            }
+            
+            throw fdl::errorUtil::fileReadError(MESSAGE);
+        }
     }
 }
\ No newline at end of file
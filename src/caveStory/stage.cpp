@@ -0,0 +1,143 @@
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include <thread>
+#include <atomic>
+
+#include <utility>
+
+#include "fdl/caveStory/pxm.hpp"
+#include "fdl/caveStory/pxe.hpp"
+#include "fdl/caveStory/pxa.hpp"
+#include "fdl/caveStory/stage.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace caveStory {
+        stageBatch loadStages(const std::string& folder, const std::vector <stageInfo>& stages, unsigned int maxThreads) {
+            //each distinct tileset's attributes are loaded once and shared by every stage using it
+            std::map <std::string, size_t> tilesetIndices;
+            std::vector <size_t> stageTilesets(stages.size());
+            
+            for (size_t i = 0; i < stages.size(); ++i) {
+                stageTilesets.at(i) = tilesetIndices.emplace(stages.at(i).tilesetName, tilesetIndices.size()).first -> second;
+            }
+            
+            const size_t NUM_STAGES = stages.size();
+            const size_t NUM_TILESETS = tilesetIndices.size();
+            
+            /*
+             * Every file is its own job: first the PXA files, since each
+             * one holds up several stages, then each stage's PXM file and
+             * then its PXE file. Each job gets its own slot in every vector
+             * so workers never write to the same place.
+             */
+            const size_t NUM_JOBS = NUM_TILESETS + NUM_STAGES * 2;
+            const size_t MAPS_START = NUM_TILESETS;
+            const size_t ENTITIES_START = MAPS_START + NUM_STAGES;
+            
+            std::vector <std::string> paths(NUM_JOBS);
+            
+            for (const auto& TILESET : tilesetIndices) {
+                paths.at(TILESET.second) = folder + '/' + TILESET.first + pxa::FILE_EXTENSION;
+            }
+            
+            for (size_t i = 0; i < NUM_STAGES; ++i) {
+                paths.at(MAPS_START + i) = folder + '/' + stages.at(i).name + pxm::FILE_EXTENSION;
+                paths.at(ENTITIES_START + i) = folder + '/' + stages.at(i).name + pxe::FILE_EXTENSION;
+            }
+            
+            std::vector <std::shared_ptr <pxa>> attributes(NUM_TILESETS);
+            std::vector <stage> loaded(NUM_STAGES);
+            std::vector <fdl::errorUtil::result> results(NUM_JOBS);
+            
+            for (std::shared_ptr <pxa>& table : attributes) {
+                table = std::make_shared <pxa>();
+            }
+            
+            std::atomic <size_t> next(0);
+            
+            const auto WORK = [&]() {
+                std::vector <uint8_t> buffer; //reused for every PXE and PXA file this worker reads
+                
+                for (size_t i = next++; i < NUM_JOBS; i = next++) {
+                    if (i < MAPS_START) {
+                        results.at(i) = attributes.at(i) -> tryLoadFile(paths.at(i), buffer);
+                    }
+                    else if (i < ENTITIES_START) {
+                        results.at(i) = loaded.at(i - MAPS_START).map.tryLoadMap(paths.at(i), pxm::LOAD_STREAM); //reads the tiles straight into the map
+                    }
+                    else {
+                        results.at(i) = loaded.at(i - ENTITIES_START).entities.tryLoadFile(paths.at(i), buffer);
+                    }
+                }
+            };
+            
+            if (0 == maxThreads) {
+                maxThreads = std::thread::hardware_concurrency();
+            }
+            
+            const size_t NUM_THREADS = ((maxThreads < NUM_JOBS) ? maxThreads : NUM_JOBS);
+            
+            std::vector <std::thread> workers;
+            workers.reserve(NUM_THREADS);
+            
+            for (size_t i = 1; i < NUM_THREADS; ++i) {
+                workers.emplace_back(WORK);
+            }
+            
+            WORK(); //the calling thread works too rather than just waiting
+            
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            
+            stageBatch batch;
+            
+            //messages are only built here, for the files that failed, rather than on each worker's error path
+            for (size_t i = 0; i < NUM_JOBS; ++i) {
+                const fdl::errorUtil::result& RESULT = results.at(i);
+                
+                if (RESULT) {
+                    continue;
+                }
+                
+                std::string message;
+                
+                if (i < MAPS_START) {
+                    message = pxa::getLoadErrorMessage(RESULT, fdl::fileUtil::stripToBaseFilename(paths.at(i), pxa::FILE_EXTENSION));
+                }
+                else if (i < ENTITIES_START) {
+                    message = pxm::getLoadErrorMessage(RESULT, fdl::fileUtil::stripToBaseFilename(paths.at(i), pxm::FILE_EXTENSION));
+                }
+                else {
+                    message = pxe::getLoadErrorMessage(RESULT, fdl::fileUtil::stripToBaseFilename(paths.at(i), pxe::FILE_EXTENSION));
+                }
+                
+                batch.errors.push_back({paths.at(i), message, RESULT.getCode(), RESULT.getOffset()});
+            }
+            
+            batch.stages.reserve(NUM_STAGES);
+            
+            for (size_t i = 0; i < NUM_STAGES; ++i) {
+                const size_t TILESET = stageTilesets.at(i);
+                
+                if (results.at(TILESET) && results.at(MAPS_START + i) && results.at(ENTITIES_START + i)) {
+                    stage& loadedStage = loaded.at(i);
+                    loadedStage.name = stages.at(i).name;
+                    loadedStage.tilesetName = stages.at(i).tilesetName;
+                    loadedStage.attributes = attributes.at(TILESET);
+                    
+                    batch.stages.push_back(std::move(loadedStage));
+                }
+            }
+            
+            return batch;
+        }
+    }
+}
\ No newline at end of file
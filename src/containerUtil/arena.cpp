@@ -0,0 +1,68 @@
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fdl/containerUtil/arena.hpp"
+
+namespace fdl {
+    namespace containerUtil {
+        constexpr size_t arena::DEFAULT_BLOCK_SIZE;
+        
+        arena::arena(const size_t initialSize) : next(nullptr), remaining(0), lastBlockSize(0),
+                                                 capacity(0), usage(0),
+                                                 lastAllocation(nullptr), lastAllocationSize(0) {
+            if (initialSize > 0) {
+                addBlock(initialSize);
+            }
+        }
+        
+        void* arena::allocate(const size_t size, const size_t alignment) {
+            size_t padding = (alignment - ((uintptr_t)next & (alignment - 1))) & (alignment - 1);
+            
+            if (nullptr == next || size + padding > remaining) {
+                addBlock(size);
+                padding = 0; //blocks are aligned for any type
+            }
+            
+            unsigned char* const ALLOCATION = next + padding;
+            next = ALLOCATION + size;
+            remaining -= size + padding;
+            usage += size + padding;
+            
+            lastAllocation = ALLOCATION;
+            lastAllocationSize = size;
+            
+            return ALLOCATION;
+        }
+        
+        void arena::deallocate(void* pointer, const size_t size) {
+            if (pointer == lastAllocation && size == lastAllocationSize) { //only the end of the current block can be reused
+                next -= size;
+                remaining += size;
+                usage -= size;
+                lastAllocation = nullptr;
+            }
+        }
+        
+        size_t arena::getCapacity() const {
+            return capacity;
+        }
+        
+        size_t arena::getUsage() const {
+            return usage;
+        }
+        
+        void arena::addBlock(const size_t minSize) {
+            const size_t SIZE = std::max(std::max(minSize, lastBlockSize * 2), (size_t)DEFAULT_BLOCK_SIZE);
+            
+            blocks.emplace_back(new unsigned char [SIZE]);
+            next = blocks.back().get();
+            remaining = SIZE;
+            lastBlockSize = SIZE;
+            capacity += SIZE;
+        }
+    }
+}
\ No newline at end of file
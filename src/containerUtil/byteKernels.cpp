@@ -0,0 +1,345 @@
+#include <array>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstddef>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/containerUtil/byteKernels.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define FDL_BYTE_KERNELS_X86
+    #include <immintrin.h> //SSE2 and AVX2 intrinsics
+#endif
+
+namespace fdl {
+    namespace containerUtil {
+        namespace {
+            struct kernelSet {
+                const char* target;
+                size_t (*replace)(uint8_t*, size_t, uint8_t, uint8_t);
+                size_t (*countDifferent)(const uint8_t*, const uint8_t*, size_t);
+                void (*blit)(uint8_t*, const uint8_t*, size_t);
+                void (*remap)(uint8_t*, const uint8_t*, size_t, const uint8_t*);
+            };
+            
+            //SCALAR
+            
+            size_t replaceScalar(uint8_t* data, const size_t size, const uint8_t from, const uint8_t to) {
+                size_t count = 0;
+                
+                for (size_t i = 0; i < size; ++i) {
+                    if (from == data[i]) {
+                        data[i] = to;
+                        ++count;
+                    }
+                }
+                
+                return count;
+            }
+            
+            size_t countDifferentScalar(const uint8_t* a, const uint8_t* b, const size_t size) {
+                size_t count = 0;
+                
+                for (size_t i = 0; i < size; ++i) {
+                    count += (a[i] != b[i]);
+                }
+                
+                return count;
+            }
+            
+            void blitScalar(uint8_t* destination, const uint8_t* source, const size_t numPixels) {
+                for (size_t i = 0; i < numPixels * 4; i += 4) {
+                    if (0 != source[i + 3]) {
+                        memcpy(destination + i, source + i, 4);
+                    }
+                }
+            }
+            
+            void remapScalar(uint8_t* destination, const uint8_t* source, const size_t size, const uint8_t* table) {
+                size_t i = 0;
+                
+                for (; i + 8 <= size; i += 8) {
+                    destination[i] = table[source[i]];
+                    destination[i + 1] = table[source[i + 1]];
+                    destination[i + 2] = table[source[i + 2]];
+                    destination[i + 3] = table[source[i + 3]];
+                    destination[i + 4] = table[source[i + 4]];
+                    destination[i + 5] = table[source[i + 5]];
+                    destination[i + 6] = table[source[i + 6]];
+                    destination[i + 7] = table[source[i + 7]];
+                }
+                
+                for (; i < size; ++i) {
+                    destination[i] = table[source[i]];
+                }
+            }
+            
+            #ifdef FDL_BYTE_KERNELS_X86
+            
+            //SSE2
+            
+            __attribute__((target("sse2")))
+            size_t replaceSse2(uint8_t* data, const size_t size, const uint8_t from, const uint8_t to) {
+                const __m128i FROM = _mm_set1_epi8(from);
+                const __m128i TO = _mm_set1_epi8(to);
+                
+                size_t count = 0;
+                size_t i = 0;
+                
+                for (; i + 16 <= size; i += 16) {
+                    const __m128i BYTES = _mm_loadu_si128((const __m128i*)(data + i));
+                    const __m128i MATCHES = _mm_cmpeq_epi8(BYTES, FROM);
+                    const int MASK = _mm_movemask_epi8(MATCHES);
+                    
+                    if (MASK) { //most blocks have no matches, so skip the store entirely
+                        count += __builtin_popcount(MASK);
+                        _mm_storeu_si128((__m128i*)(data + i), _mm_or_si128(_mm_andnot_si128(MATCHES, BYTES),
+                                                                            _mm_and_si128(MATCHES, TO)));
+                    }
+                }
+                
+                return count + replaceScalar(data + i, size - i, from, to);
+            }
+            
+            __attribute__((target("sse2")))
+            size_t countDifferentSse2(const uint8_t* a, const uint8_t* b, const size_t size) {
+                const __m128i ZERO = _mm_setzero_si128();
+                
+                __m128i totals = ZERO; //two 64-bit sums
+                size_t i = 0;
+                
+                while (i + 16 <= size) {
+                    //count equal bytes in 8-bit lanes (subtracting the all-ones match mask adds 1), flushing before they can overflow
+                    __m128i equal = ZERO;
+                    
+                    for (int j = 0; j < 255 && i + 16 <= size; ++j, i += 16) {
+                        const __m128i A = _mm_loadu_si128((const __m128i*)(a + i));
+                        const __m128i B = _mm_loadu_si128((const __m128i*)(b + i));
+                        equal = _mm_sub_epi8(equal, _mm_cmpeq_epi8(A, B));
+                    }
+                    
+                    totals = _mm_add_epi64(totals, _mm_sad_epu8(equal, ZERO));
+                }
+                
+                const size_t EQUAL = (size_t)_mm_cvtsi128_si64(totals) + (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(totals, totals));
+                
+                return (i - EQUAL) + countDifferentScalar(a + i, b + i, size - i);
+            }
+            
+            __attribute__((target("sse2")))
+            void blitSse2(uint8_t* destination, const uint8_t* source, const size_t numPixels) {
+                const __m128i ALPHA = _mm_set1_epi32((int)0xFF000000); //alpha is the high byte of each little-endian pixel
+                const __m128i ZERO = _mm_setzero_si128();
+                
+                size_t i = 0;
+                
+                for (; i + 4 <= numPixels; i += 4) {
+                    const __m128i SOURCE = _mm_loadu_si128((const __m128i*)(source + i * 4));
+                    const __m128i DESTINATION = _mm_loadu_si128((const __m128i*)(destination + i * 4));
+                    const __m128i TRANSPARENT = _mm_cmpeq_epi32(_mm_and_si128(SOURCE, ALPHA), ZERO);
+                    
+                    _mm_storeu_si128((__m128i*)(destination + i * 4), _mm_or_si128(_mm_and_si128(TRANSPARENT, DESTINATION),
+                                                                                   _mm_andnot_si128(TRANSPARENT, SOURCE)));
+                }
+                
+                blitScalar(destination + i * 4, source + i * 4, numPixels - i);
+            }
+            
+            //AVX2
+            
+            __attribute__((target("avx2")))
+            size_t replaceAvx2(uint8_t* data, const size_t size, const uint8_t from, const uint8_t to) {
+                const __m256i FROM = _mm256_set1_epi8(from);
+                const __m256i TO = _mm256_set1_epi8(to);
+                
+                size_t count = 0;
+                size_t i = 0;
+                
+                for (; i + 32 <= size; i += 32) {
+                    const __m256i BYTES = _mm256_loadu_si256((const __m256i*)(data + i));
+                    const __m256i MATCHES = _mm256_cmpeq_epi8(BYTES, FROM);
+                    const unsigned int MASK = _mm256_movemask_epi8(MATCHES);
+                    
+                    if (MASK) {
+                        count += __builtin_popcount(MASK);
+                        _mm256_storeu_si256((__m256i*)(data + i), _mm256_blendv_epi8(BYTES, TO, MATCHES));
+                    }
+                }
+                
+                return count + replaceScalar(data + i, size - i, from, to);
+            }
+            
+            __attribute__((target("avx2")))
+            size_t countDifferentAvx2(const uint8_t* a, const uint8_t* b, const size_t size) {
+                const __m256i ZERO = _mm256_setzero_si256();
+                
+                __m256i totals = ZERO; //four 64-bit sums
+                size_t i = 0;
+                
+                while (i + 32 <= size) {
+                    __m256i equal = ZERO;
+                    
+                    for (int j = 0; j < 255 && i + 32 <= size; ++j, i += 32) {
+                        const __m256i A = _mm256_loadu_si256((const __m256i*)(a + i));
+                        const __m256i B = _mm256_loadu_si256((const __m256i*)(b + i));
+                        equal = _mm256_sub_epi8(equal, _mm256_cmpeq_epi8(A, B));
+                    }
+                    
+                    totals = _mm256_add_epi64(totals, _mm256_sad_epu8(equal, ZERO));
+                }
+                
+                const size_t EQUAL = (size_t)_mm256_extract_epi64(totals, 0) + (size_t)_mm256_extract_epi64(totals, 1) +
+                                     (size_t)_mm256_extract_epi64(totals, 2) + (size_t)_mm256_extract_epi64(totals, 3);
+                
+                return (i - EQUAL) + countDifferentScalar(a + i, b + i, size - i);
+            }
+            
+            __attribute__((target("avx2")))
+            void blitAvx2(uint8_t* destination, const uint8_t* source, const size_t numPixels) {
+                const __m256i ALPHA = _mm256_set1_epi32((int)0xFF000000);
+                const __m256i ZERO = _mm256_setzero_si256();
+                
+                size_t i = 0;
+                
+                for (; i + 8 <= numPixels; i += 8) { //a whole row of an 8x8 tile at once
+                    const __m256i SOURCE = _mm256_loadu_si256((const __m256i*)(source + i * 4));
+                    const __m256i DESTINATION = _mm256_loadu_si256((const __m256i*)(destination + i * 4));
+                    const __m256i TRANSPARENT = _mm256_cmpeq_epi32(_mm256_and_si256(SOURCE, ALPHA), ZERO);
+                    
+                    _mm256_storeu_si256((__m256i*)(destination + i * 4), _mm256_blendv_epi8(SOURCE, DESTINATION, TRANSPARENT));
+                }
+                
+                blitScalar(destination + i * 4, source + i * 4, numPixels - i);
+            }
+            
+            /*
+             * A byte shuffle only looks up a 16-entry table, so the 256-entry
+             * table is split into 16 rows of 16. Adding a bias with unsigned
+             * saturation leaves a byte's low nibble as the index into the row
+             * its high nibble picks, but sets the index's top bit (which makes
+             * the shuffle return 0) for rows below it. Rows above it still
+             * look something up, so each row is stored XORed with the next
+             * and XORing every lookup together cancels out all but the right
+             * entry. Bytes from 128 up are handled the same way with their top
+             * bit flipped, against the second half of the table.
+             *
+             * That's 16 shuffles per 32 bytes, which only just beats one load
+             * and store per byte; with SSE2's 16-byte vectors (and SSSE3's
+             * shuffles) it loses, so the SSE2 kernels keep the scalar gather.
+             */
+            __attribute__((target("avx2")))
+            void remapAvx2(uint8_t* destination, const uint8_t* source, const size_t size, const uint8_t* table) {
+                const __m256i HIGH_BIT = _mm256_set1_epi8((char)0x80);
+                
+                __m256i rows [16]; //each row in both lanes, since shuffles don't cross them
+                
+                for (int j = 0; j < 16; ++j) {
+                    __m128i row = _mm_loadu_si128((const __m128i*)(table + j * 16));
+                    
+                    if (7 != j % 8) { //the last row of each half has nothing after it to cancel
+                        row = _mm_xor_si128(row, _mm_loadu_si128((const __m128i*)(table + (j + 1) * 16)));
+                    }
+                    
+                    rows[j] = _mm256_broadcastsi128_si256(row);
+                }
+                
+                size_t i = 0;
+                
+                for (; i + 32 <= size; i += 32) {
+                    const __m256i BYTES = _mm256_loadu_si256((const __m256i*)(source + i));
+                    const __m256i FLIPPED = _mm256_xor_si256(BYTES, HIGH_BIT);
+                    
+                    __m256i remapped = _mm256_setzero_si256();
+                    
+                    #pragma GCC unroll 8
+                    for (int j = 0; j < 8; ++j) {
+                        const __m256i BIAS = _mm256_set1_epi8((char)(0x70 - j * 16));
+                        remapped = _mm256_xor_si256(remapped, _mm256_shuffle_epi8(rows[j], _mm256_adds_epu8(BYTES, BIAS)));
+                        remapped = _mm256_xor_si256(remapped, _mm256_shuffle_epi8(rows[j + 8], _mm256_adds_epu8(FLIPPED, BIAS)));
+                    }
+                    
+                    _mm256_storeu_si256((__m256i*)(destination + i), remapped);
+                }
+                
+                remapScalar(destination + i, source + i, size - i, table);
+            }
+            
+            #endif //FDL_BYTE_KERNELS_X86
+            
+            kernelSet selectKernels() {
+                #ifdef FDL_BYTE_KERNELS_X86
+                __builtin_cpu_init();
+                
+                if (__builtin_cpu_supports("avx2")) {
+                    return {"avx2", replaceAvx2, countDifferentAvx2, blitAvx2, remapAvx2};
+                }
+                
+                if (__builtin_cpu_supports("sse2")) {
+                    return {"sse2", replaceSse2, countDifferentSse2, blitSse2, remapScalar};
+                }
+                #endif
+                
+                return {"scalar", replaceScalar, countDifferentScalar, blitScalar, remapScalar};
+            }
+            
+            const kernelSet& getKernels() {
+                static const kernelSet KERNELS = selectKernels(); //chosen once; thread-safe since C++11
+                return KERNELS;
+            }
+        }
+        
+        size_t replaceBytes(uint8_t* data, const size_t size, const uint8_t from, const uint8_t to) {
+            return getKernels().replace(data, size, from, to);
+        }
+        
+        size_t countDifferentBytes(const uint8_t* a, const uint8_t* b, const size_t size) {
+            return getKernels().countDifferent(a, b, size);
+        }
+        
+        void blitPixels(uint8_t* destination, const uint8_t* source, const size_t numPixels) {
+            getKernels().blit(destination, source, numPixels);
+        }
+        
+        void countBytes(const uint8_t* data, const size_t size, std::array <size_t, 256>& histogram) {
+            /*
+             * A histogram can't be vectorized without scatter stores, which
+             * x86 lacks for bytes. Counting into four tables instead of one
+             * keeps runs of the same tile from stalling on one counter.
+             */
+            uint32_t counts [4][256] = {{0}};
+            size_t i = 0;
+            
+            while (i < size) {
+                //flush before a 32-bit counter could overflow
+                const size_t END = i + std::min(size - i, (size_t)1 << 30);
+                
+                for (; i + 4 <= END; i += 4) {
+                    ++counts[0][data[i]];
+                    ++counts[1][data[i + 1]];
+                    ++counts[2][data[i + 2]];
+                    ++counts[3][data[i + 3]];
+                }
+                
+                for (; i < END; ++i) {
+                    ++counts[0][data[i]];
+                }
+                
+                for (int j = 0; j < 256; ++j) {
+                    histogram[j] += (size_t)counts[0][j] + counts[1][j] + counts[2][j] + counts[3][j];
+                    counts[0][j] = counts[1][j] = counts[2][j] = counts[3][j] = 0;
+                }
+            }
+        }
+        
+        void remapBytes(uint8_t* destination, const uint8_t* source, const size_t size,
+                        const std::array <uint8_t, 256>& table) {
+            getKernels().remap(destination, source, size, table.data());
+        }
+        
+        const char* getByteKernelTarget() {
+            return getKernels().target;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <string>
+#include <unordered_map>
+#include <memory>
+
+#include <mutex>
+#include <atomic>
+
+#include <stdexcept>
+
+#include <cstdint>
+
+#include "fdl/containerUtil/stringPool.hpp"
+
+namespace fdl {
+    namespace containerUtil {
+        constexpr stringPool::handle stringPool::EMPTY;
+        
+        constexpr size_t stringPool::CHUNK_SIZE;
+        constexpr size_t stringPool::MAX_NUM_CHUNKS;
+        constexpr size_t stringPool::MAX_NUM_STRINGS;
+        
+        stringPool::stringPool() : count(0) {
+            intern("");
+        }
+        
+        stringPool::handle stringPool::intern(const std::string& str) {
+            handle id = EMPTY;
+            
+            if (!tryIntern(str, id)) {
+                throw std::length_error("ERROR: Attempt to intern more than " + std::to_string(MAX_NUM_STRINGS) +
+                                        " strings in one string pool.");
+            }
+            
+            return id;
+        }
+        
+        bool stringPool::tryIntern(const std::string& str, handle& id) {
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            const auto FOUND = index.find(str);
+            
+            if (index.end() != FOUND) {
+                id = FOUND -> second;
+                return true;
+            }
+            
+            const size_t ID = count.load(std::memory_order_relaxed);
+            
+            if (ID >= MAX_NUM_STRINGS) {
+                return false;
+            }
+            
+            std::unique_ptr <const std::string* []>& chunk = chunks[ID / CHUNK_SIZE];
+            
+            if (!chunk) {
+                chunk.reset(new const std::string* [CHUNK_SIZE]);
+            }
+            
+            const auto INSERTED = index.emplace(str, ID).first;
+            chunk[ID % CHUNK_SIZE] = &(INSERTED -> first);
+            
+            count.store(ID + 1, std::memory_order_release); //publishes the new entry to get() without locking
+            
+            id = ID;
+            return true;
+        }
+        
+        bool stringPool::find(const std::string& str, handle& id) const {
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            const auto FOUND = index.find(str);
+            
+            if (index.end() == FOUND) {
+                return false;
+            }
+            
+            id = FOUND -> second;
+            return true;
+        }
+        
+        const std::string& stringPool::get(const handle id) const {
+            if (id >= count.load(std::memory_order_acquire)) {
+                throw std::out_of_range("ERROR: Attempt to get string " + std::to_string(id) + " from a string pool holding " +
+                                        std::to_string(size()) + " strings.");
+            }
+            
+            return *chunks[id / CHUNK_SIZE][id % CHUNK_SIZE];
+        }
+        
+        size_t stringPool::size() const {
+            return count.load(std::memory_order_acquire);
+        }
+    }
+}
\ No newline at end of file
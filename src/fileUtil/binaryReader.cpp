@@ -0,0 +1,98 @@
+#include <string>
+#include <vector>
+
+#include <algorithm> //find(InputIt first, InputIt last, const T& value)
+
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/fileUtil/binaryReader.hpp"
+#include "fdl/fileUtil/mappedFile.hpp"
+
+namespace fdl {
+    namespace fileUtil {
+        binaryReader::binaryReader(const uint8_t* data, const size_t size) : data(data), size(size), pos(0), fail(false) {}
+        
+        binaryReader::binaryReader(const std::vector <uint8_t>& buffer) : binaryReader(buffer.data(), buffer.size()) {}
+        
+        binaryReader::binaryReader(const mappedFile& file) : binaryReader(file.data(), file.size()) {}
+        
+        bool binaryReader::good() const {
+            return !fail;
+        }
+        
+        size_t binaryReader::tell() const {
+            return pos;
+        }
+        
+        size_t binaryReader::getSize() const {
+            return size;
+        }
+        
+        size_t binaryReader::getRemaining() const {
+            return size - pos;
+        }
+        
+        uint8_t binaryReader::get() {
+            if (pos >= size) {
+                fail = true;
+                return 0;
+            }
+            
+            return data[pos++];
+        }
+        
+        void binaryReader::read(void* dest, const size_t count) {
+            const size_t AVAILABLE = ((count < size - pos) ? count : size - pos); //like std::istream::read(), copy what's there before failing
+            
+            if (AVAILABLE > 0) {
+                memcpy(dest, data + pos, AVAILABLE);
+            }
+            
+            pos += AVAILABLE;
+            
+            if (AVAILABLE < count) {
+                fail = true;
+            }
+        }
+        
+        void binaryReader::ignore(const size_t count) {
+            skip(count);
+        }
+        
+        bool binaryReader::readString(std::string& dest) {
+            const size_t STRING_POS = pos;
+            const uint8_t* const LENGTH = skip(1);
+            const uint8_t* const START = ((nullptr != LENGTH) ? skip(*LENGTH) : nullptr);
+            
+            if (nullptr == START) {
+                pos = STRING_POS; //back to the length, where the failed read started
+                return false;
+            }
+            
+            dest.assign(START, std::find(START, START + *LENGTH, '\0'));
+            return true;
+        }
+        
+        bool binaryReader::readString(char* dest, const size_t capacity) {
+            if (pos >= size || (size_t)data[pos] + 1 > capacity) { //check the length before moving past it, so nothing is copied
+                fail = true;
+                return false;
+            }
+            
+            const uint8_t LEN = data[pos];
+            const uint8_t* const START = skip(1 + LEN);
+            
+            if (nullptr == START) {
+                return false;
+            }
+            
+            const uint8_t* const END = std::find(START + 1, START + 1 + LEN, '\0');
+            memcpy(dest, START + 1, END - (START + 1));
+            dest[END - (START + 1)] = '\0';
+            
+            return true;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/fileUtil/binaryWriter.hpp"
+
+namespace fdl {
+    namespace fileUtil {
+        binaryWriter::binaryWriter(uint8_t* data, const size_t size) : data(data), size(size), pos(0), fail(false) {}
+        
+        binaryWriter::binaryWriter(std::vector <uint8_t>& buffer) : binaryWriter(buffer.data(), buffer.size()) {}
+        
+        bool binaryWriter::good() const {
+            return !fail;
+        }
+        
+        size_t binaryWriter::tell() const {
+            return pos;
+        }
+        
+        size_t binaryWriter::getSize() const {
+            return size;
+        }
+        
+        size_t binaryWriter::getRemaining() const {
+            return size - pos;
+        }
+        
+        void binaryWriter::put(const uint8_t value) {
+            uint8_t* const OUT = reserve(1);
+            
+            if (nullptr != OUT) {
+                *OUT = value;
+            }
+        }
+        
+        void binaryWriter::write(const void* src, const size_t count) {
+            uint8_t* const OUT = reserve(count);
+            
+            if (nullptr != OUT && count > 0) {
+                memcpy(OUT, src, count);
+            }
+        }
+        
+        bool binaryWriter::writeString(const std::string& str) {
+            if (str.size() > UINT8_MAX) {
+                fail = true;
+                return false;
+            }
+            
+            uint8_t* const OUT = reserve(1 + str.size());
+            
+            if (nullptr == OUT) {
+                return false;
+            }
+            
+            *OUT = str.size();
+            memcpy(OUT + 1, str.data(), str.size());
+            
+            return true;
+        }
+    }
+}
\ No newline at end of file
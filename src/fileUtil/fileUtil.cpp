@@ -1,14 +1,25 @@
 #include <string>
+#include <vector>
 
 #include <fstream>
 
 #include <algorithm>
 
 #include <cstdint>
+#include <cerrno>
+
+#include <cstdio> //rename(const char* oldname, const char* newname), remove(const char* filename)
+#include <cstdlib> //mkstemp(char* templ)
 
 /* TODO: Find more cross-platform replacement for this since
         unistd.h isn't on all platforms and compilers */
-#include <unistd.h> //access(const char* path, int amode)
+#include <unistd.h> //access(const char* path, int amode), write(...), fsync(int fd), close(int fd)
+#include <fcntl.h> //open(const char* path, int oflag)
+#include <sys/stat.h> //stat(const char* path, struct stat* buf), fchmod(int fd, mode_t mode)
+#include <dirent.h> //opendir(const char* dirname), readdir(DIR* dirp), closedir(DIR* dirp)
+
+#include "fdl/errorUtil/errorUtil.hpp"
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
 
 #include "fdl/fileUtil/fileUtil.hpp"
 
@@ -41,5 +52,115 @@ namespace fdl {
         bool fileExists(const std::string& fname) {
             return (access(fname.c_str(), F_OK) == 0);
         }
+        
+        bool getFileStatus(const std::string& fname, fileStatus& status) {
+            struct stat info;
+            
+            if (stat(fname.c_str(), &info) != 0) {
+                return false;
+            }
+            
+            status.size = info.st_size;
+            status.modifiedTime = (int64_t)info.st_mtim.tv_sec * 1'000'000'000 + info.st_mtim.tv_nsec;
+            return true;
+        }
+        
+        fdl::errorUtil::result readFile(const std::string& fname, std::vector <uint8_t>& buffer) {
+            std::ifstream file(fname, std::ifstream::in | std::ifstream::binary);
+            
+            if (!file) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_OPENFAIL, 0);
+            }
+            
+            file.seekg(0, std::ifstream::end);
+            const std::streamoff SIZE = file.tellg();
+            file.seekg(0, std::ifstream::beg);
+            
+            if (SIZE < 0) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_READFAIL, 0);
+            }
+            
+            buffer.resize(SIZE);
+            file.read((char*)buffer.data(), buffer.size());
+            
+            if (!file.good()) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_READFAIL, file.gcount()); //the offset at which reading stopped
+            }
+            
+            return fdl::errorUtil::result();
+        }
+        
+        bool writeFileAtomically(const std::string& fname, const uint8_t* data, const size_t size) {
+            //each call gets its own temporary file, so concurrent saves of the same file can't clobber each other's
+            std::vector <char> tempName(fname.begin(), fname.end());
+            const char SUFFIX [] = ".XXXXXX";
+            tempName.insert(tempName.end(), SUFFIX, SUFFIX + sizeof(SUFFIX)); //includes the null terminator
+            
+            const int FD = mkstemp(tempName.data());
+            
+            if (FD < 0) {
+                return false;
+            }
+            
+            //mkstemp() makes the file private, so give it the permissions of the file it replaces (or the usual ones)
+            struct stat existing;
+            const mode_t MODE = ((0 == stat(fname.c_str(), &existing)) ? (existing.st_mode & 07777) : 0644);
+            bool written = (0 == fchmod(FD, MODE));
+            
+            for (size_t offset = 0; written && offset < size;) {
+                const ssize_t COUNT = write(FD, data + offset, size - offset);
+                
+                if (COUNT > 0) {
+                    offset += COUNT;
+                }
+                else if (0 == COUNT || EINTR != errno) { //writing nothing would otherwise retry forever
+                    written = false;
+                }
+            }
+            
+            //the data has to reach the disk before the rename does, or a crash could leave a renamed but empty file
+            written = (written && 0 == fsync(FD));
+            written = (0 == close(FD) && written);
+            
+            if (!written || 0 != rename(tempName.data(), fname.c_str())) {
+                remove(tempName.data());
+                return false;
+            }
+            
+            //make the rename itself durable; the file is already replaced, so failing to do so isn't an error
+            const size_t SLASH = fname.find_last_of('/');
+            const std::string FOLDER = ((std::string::npos == SLASH) ? "." : fname.substr(0, SLASH + 1));
+            const int FOLDER_FD = open(FOLDER.c_str(), O_RDONLY);
+            
+            if (FOLDER_FD >= 0) {
+                fsync(FOLDER_FD);
+                close(FOLDER_FD);
+            }
+            
+            return true;
+        }
+        
+        std::vector <std::string> listFiles(const std::string& folder, const std::string& extension) {
+            DIR* const DIRECTORY = opendir(folder.c_str());
+            
+            if (nullptr == DIRECTORY) {
+                throw fdl::errorUtil::fileOpenError("ERROR: Failed to open folder " + folder + " for listing.");
+            }
+            
+            std::vector <std::string> files;
+            
+            for (const dirent* entry = readdir(DIRECTORY); nullptr != entry; entry = readdir(DIRECTORY)) {
+                const std::string NAME = entry -> d_name;
+                
+                if (NAME.size() > extension.size() && stripExtensionFromFilename(NAME, extension) != NAME) {
+                    files.push_back(NAME);
+                }
+            }
+            
+            closedir(DIRECTORY);
+            
+            std::sort(files.begin(), files.end());
+            return files;
+        }
     }
 }
\ No newline at end of file
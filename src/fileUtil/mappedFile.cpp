@@ -0,0 +1,92 @@
+#include <string>
+#include <memory>
+
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
+
+#include <cstdint>
+
+/* TODO: Find more cross-platform replacement for these since
+        they're POSIX-only (see fileUtil.cpp) */
+#include <fcntl.h> //open(const char* path, int oflag)
+#include <unistd.h> //close(int fd)
+#include <sys/stat.h> //fstat(int fd, struct stat* buf)
+#include <sys/mman.h> //mmap(...), munmap(void* addr, size_t len)
+
+#include "fdl/fileUtil/mappedFile.hpp"
+
+namespace fdl {
+    namespace fileUtil {
+        mappedFile::mappedFile(const std::string& fname) : bytes(nullptr), length(0) {
+            switch (map(fname, bytes, length)) {
+                case MAP_OPENFAIL:
+                    throw fdl::errorUtil::fileOpenError("ERROR: Failed to open file " + fname + " for mapping.");
+                    
+                case MAP_STATFAIL:
+                    throw fdl::errorUtil::fileOpenError("ERROR: Failed to get size of file " + fname + " for mapping.");
+                    
+                case MAP_MMAPFAIL:
+                    throw fdl::errorUtil::fileOpenError("ERROR: Failed to map file " + fname + '.');
+                    
+                default:
+                    break;
+            }
+        }
+        
+        mappedFile::mappedFile(const uint8_t* bytes, const size_t length) : bytes(bytes), length(length) {}
+        
+        std::shared_ptr <const mappedFile> mappedFile::tryMap(const std::string& fname) {
+            const uint8_t* bytes = nullptr;
+            size_t length = 0;
+            
+            if (MAP_OK != map(fname, bytes, length)) {
+                return nullptr;
+            }
+            
+            return std::shared_ptr <const mappedFile>(new mappedFile(bytes, length)); //the constructor is private, so std::make_shared can't call it
+        }
+        
+        mappedFile::mapStatus mappedFile::map(const std::string& fname, const uint8_t*& bytes, size_t& length) {
+            const int FD = ::open(fname.c_str(), O_RDONLY);
+            
+            if (FD < 0) {
+                return MAP_OPENFAIL;
+            }
+            
+            struct stat info;
+            if (fstat(FD, &info) != 0) {
+                close(FD);
+                return MAP_STATFAIL;
+            }
+            
+            length = info.st_size;
+            
+            if (length > 0) { //mapping 0 bytes is an error, so empty files are just left unmapped
+                void* const MAPPING = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, FD, 0);
+                
+                if (MAP_FAILED == MAPPING) {
+                    close(FD);
+                    return MAP_MMAPFAIL;
+                }
+                
+                bytes = static_cast <const uint8_t*>(MAPPING);
+            }
+            
+            close(FD); //the mapping stays valid after the descriptor is closed
+            return MAP_OK;
+        }
+        
+        mappedFile::~mappedFile() {
+            if (nullptr != bytes) {
+                munmap(const_cast <uint8_t*>(bytes), length);
+            }
+        }
+        
+        const uint8_t* mappedFile::data() const {
+            return bytes;
+        }
+        
+        size_t mappedFile::size() const {
+            return length;
+        }
+    }
+}
\ No newline at end of file
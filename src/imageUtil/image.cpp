@@ -0,0 +1,360 @@
+#include <string>
+#include <vector>
+#include <array>
+
+#include <algorithm>
+#include <utility>
+
+#include "fdl/errorUtil/errorUtilExceptions.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/imageUtil/image.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace imageUtil {
+        namespace {
+            //NETPBM HEADERS
+            
+            //reads header text, where any run of whitespace and comments separates tokens
+            class headerReader {
+                private:
+                    const uint8_t* data;
+                    size_t size;
+                    size_t pos;
+                    
+                public:
+                    headerReader(const uint8_t* data, const size_t size) : data(data), size(size), pos(0) {}
+                    
+                    size_t tell() const {
+                        return pos;
+                    }
+                    
+                    void skipSpace() {
+                        while (pos < size) {
+                            if ('#' == data[pos]) {
+                                while (pos < size && '\n' != data[pos]) {
+                                    ++pos;
+                                }
+                            }
+                            else if (' ' == data[pos] || '\t' == data[pos] || '\n' == data[pos] || '\r' == data[pos]) {
+                                ++pos;
+                            }
+                            else {
+                                return;
+                            }
+                        }
+                    }
+                    
+                    std::string readToken() {
+                        skipSpace();
+                        const size_t START = pos;
+                        
+                        while (pos < size && ' ' != data[pos] && '\t' != data[pos] && '\n' != data[pos] && '\r' != data[pos]) {
+                            ++pos;
+                        }
+                        
+                        return std::string((const char*)data + START, pos - START);
+                    }
+                    
+                    bool readNumber(uint32_t& value) {
+                        const std::string TOKEN = readToken();
+                        
+                        if (TOKEN.empty() || TOKEN.size() > 9 || TOKEN.find_first_not_of("0123456789") != std::string::npos) {
+                            return false;
+                        }
+                        
+                        value = std::stoul(TOKEN);
+                        return true;
+                    }
+                    
+                    //the single whitespace character between the header and the pixels
+                    bool endHeader() {
+                        if (pos >= size || (' ' != data[pos] && '\t' != data[pos] && '\n' != data[pos] && '\r' != data[pos])) {
+                            return false;
+                        }
+                        
+                        ++pos;
+                        return true;
+                    }
+            };
+            
+            //PNG CHUNKS
+            
+            const uint8_t PNG_SIGNATURE [] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+            
+            constexpr size_t MAX_STORED_BLOCK = 65535; /**< Most bytes a stored deflate block can hold */
+            constexpr size_t MAX_CHUNK = (size_t)1 << 30; /**< Most bytes put in one IDAT chunk (PNG allows up to 2^31 - 1) */
+            
+            constexpr uint32_t ADLER_MOD = 65521; /**< Largest prime below 2^16, which Adler-32 sums are taken modulo */
+            constexpr size_t ADLER_RUN = 5552; /**< Most bytes that can be summed before an Adler-32 sum could overflow */
+            
+            std::array <uint32_t, 256> makeCrcTable() {
+                std::array <uint32_t, 256> table;
+                
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t crc = i;
+                    
+                    for (int j = 0; j < 8; ++j) {
+                        crc = ((crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1));
+                    }
+                    
+                    table[i] = crc;
+                }
+                
+                return table;
+            }
+            
+            uint32_t crc32(const uint8_t* data, const size_t size) {
+                static const std::array <uint32_t, 256> TABLE = makeCrcTable();
+                
+                uint32_t crc = 0xFFFFFFFF;
+                
+                for (size_t i = 0; i < size; ++i) {
+                    crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+                }
+                
+                return crc ^ 0xFFFFFFFF;
+            }
+            
+            void putBigEndian(std::vector <uint8_t>& out, const uint32_t value) {
+                out.push_back(value >> 24);
+                out.push_back(value >> 16);
+                out.push_back(value >> 8);
+                out.push_back(value);
+            }
+            
+            void putChunk(std::vector <uint8_t>& out, const char* type, const uint8_t* data, const size_t size) {
+                putBigEndian(out, size);
+                
+                const size_t START = out.size();
+                out.insert(out.end(), type, type + 4);
+                out.insert(out.end(), data, data + size);
+                
+                putBigEndian(out, crc32(out.data() + START, out.size() - START));
+            }
+        }
+        
+        rgbaImage::rgbaImage(const uint32_t width, const uint32_t height, const std::array <uint8_t, 4>& colour) :
+                             width(width), height(height), pixels((size_t)width * height * 4) {
+            for (size_t i = 0; i < pixels.size(); i += 4) {
+                memcpy(pixels.data() + i, colour.data(), 4);
+            }
+        }
+        
+        bool decodeNetpbm(const uint8_t* data, const size_t size, rgbaImage& image) {
+            image = rgbaImage();
+            
+            headerReader header(data, size);
+            const std::string MAGIC = header.readToken();
+            
+            uint32_t width = 0, height = 0, depth = 3, maxValue = 0;
+            
+            if ("P6" == MAGIC) {
+                if (!header.readNumber(width) || !header.readNumber(height) || !header.readNumber(maxValue) || !header.endHeader()) {
+                    return false;
+                }
+            }
+            else if ("P7" == MAGIC) {
+                for (std::string key = header.readToken(); "ENDHDR" != key; key = header.readToken()) {
+                    if ("WIDTH" == key) {
+                        if (!header.readNumber(width)) {
+                            return false;
+                        }
+                    }
+                    else if ("HEIGHT" == key) {
+                        if (!header.readNumber(height)) {
+                            return false;
+                        }
+                    }
+                    else if ("DEPTH" == key) {
+                        if (!header.readNumber(depth)) {
+                            return false;
+                        }
+                    }
+                    else if ("MAXVAL" == key) {
+                        if (!header.readNumber(maxValue)) {
+                            return false;
+                        }
+                    }
+                    else if ("TUPLTYPE" == key) {
+                        header.readToken(); //implied by the depth
+                    }
+                    else {
+                        return false; //unknown key, or the data ended before ENDHDR
+                    }
+                }
+                
+                if (!header.endHeader()) {
+                    return false;
+                }
+            }
+            else {
+                return false;
+            }
+            
+            if (255 != maxValue || (3 != depth && 4 != depth)) {
+                return false;
+            }
+            
+            const size_t NUM_PIXELS = (size_t)width * height;
+            
+            if (NUM_PIXELS > (size - header.tell()) / depth) {
+                return false;
+            }
+            
+            rgbaImage decoded(width, height, {{0, 0, 0, 255}});
+            const uint8_t* in = data + header.tell();
+            
+            if (4 == depth) {
+                if (NUM_PIXELS > 0) {
+                    memcpy(decoded.pixels.data(), in, NUM_PIXELS * 4);
+                }
+            }
+            else {
+                uint8_t* out = decoded.pixels.data();
+                
+                for (size_t i = 0; i < NUM_PIXELS; ++i, in += 3, out += 4) {
+                    memcpy(out, in, 3);
+                }
+            }
+            
+            image = std::move(decoded);
+            return true;
+        }
+        
+        rgbaImage loadNetpbm(const std::string& filename) {
+            std::vector <uint8_t> buffer;
+            const fdl::errorUtil::result RESULT = fdl::fileUtil::readFile(filename, buffer);
+            
+            if (fdl::errorUtil::FILE_OPENFAIL == RESULT.getCode()) {
+                throw fdl::errorUtil::fileOpenError("ERROR: Failed to open image file " + filename + " for parsing.");
+            }
+            
+            rgbaImage image;
+            
+            if (!RESULT || !decodeNetpbm(buffer.data(), buffer.size(), image)) {
+                throw fdl::errorUtil::fileReadError("ERROR: Could not parse image file " + filename +
+                                                    " as a PPM or PAM image with a maximum value of 255.");
+            }
+            
+            return image;
+        }
+        
+        std::vector <uint8_t> encodePpm(const rgbaImage& image) {
+            const std::string HEADER = "P6\n" + std::to_string(image.width) + ' ' + std::to_string(image.height) + "\n255\n";
+            const size_t NUM_PIXELS = (size_t)image.width * image.height;
+            
+            std::vector <uint8_t> file(HEADER.size() + NUM_PIXELS * 3);
+            memcpy(file.data(), HEADER.data(), HEADER.size());
+            
+            uint8_t* out = file.data() + HEADER.size();
+            const uint8_t* in = image.pixels.data();
+            
+            for (size_t i = 0; i < NUM_PIXELS; ++i, in += 4, out += 3) {
+                memcpy(out, in, 3);
+            }
+            
+            return file;
+        }
+        
+        std::vector <uint8_t> encodePng(const rgbaImage& image) {
+            const size_t ROW_SIZE = (size_t)image.width * 4 + 1; //each row starts with its filter type (0, none)
+            const size_t RAW_SIZE = ROW_SIZE * image.height;
+            const size_t NUM_BLOCKS = std::max((RAW_SIZE + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK, (size_t)1);
+            
+            //zlib header, stored blocks (each with a 5-byte header) and the Adler-32 checksum of the raw data
+            std::vector <uint8_t> stream;
+            stream.reserve(2 + RAW_SIZE + NUM_BLOCKS * 5 + 4);
+            stream.push_back(0x78);
+            stream.push_back(0x01);
+            
+            uint32_t adlerA = 1, adlerB = 0;
+            size_t blockLeft = 0, rawLeft = RAW_SIZE;
+            
+            const auto PUT_RAW = [&](const uint8_t* data, size_t size) {
+                while (size > 0) {
+                    if (0 == blockLeft) {
+                        blockLeft = std::min(rawLeft, MAX_STORED_BLOCK);
+                        rawLeft -= blockLeft;
+                        
+                        stream.push_back((0 == rawLeft) ? 1 : 0); //whether this is the final block
+                        stream.push_back(blockLeft);
+                        stream.push_back(blockLeft >> 8);
+                        stream.push_back(~blockLeft);
+                        stream.push_back(~blockLeft >> 8);
+                    }
+                    
+                    const size_t COUNT = std::min(size, blockLeft);
+                    stream.insert(stream.end(), data, data + COUNT);
+                    
+                    //the sums can't overflow 32 bits within ADLER_RUN bytes, so they're only reduced once per run
+                    for (size_t i = 0; i < COUNT; i += ADLER_RUN) {
+                        const size_t END = std::min(COUNT, i + ADLER_RUN);
+                        
+                        for (size_t j = i; j < END; ++j) {
+                            adlerA += data[j];
+                            adlerB += adlerA;
+                        }
+                        
+                        adlerA %= ADLER_MOD;
+                        adlerB %= ADLER_MOD;
+                    }
+                    
+                    data += COUNT;
+                    size -= COUNT;
+                    blockLeft -= COUNT;
+                }
+            };
+            
+            if (0 == RAW_SIZE) {
+                stream.insert(stream.end(), {1, 0, 0, 0xFF, 0xFF}); //a single empty final block
+            }
+            
+            const uint8_t FILTER = 0;
+            
+            for (uint32_t y = 0; y < image.height; ++y) {
+                PUT_RAW(&FILTER, 1);
+                PUT_RAW(image.getRow(y), ROW_SIZE - 1);
+            }
+            
+            putBigEndian(stream, (adlerB << 16) | adlerA);
+            
+            std::vector <uint8_t> file(PNG_SIGNATURE, PNG_SIGNATURE + sizeof(PNG_SIGNATURE));
+            file.reserve(stream.size() + 128);
+            
+            //width, height, bit depth 8, colour type 6 (RGBA), and default compression, filtering and interlacing
+            std::vector <uint8_t> head;
+            putBigEndian(head, image.width);
+            putBigEndian(head, image.height);
+            head.insert(head.end(), {8, 6, 0, 0, 0});
+            putChunk(file, "IHDR", head.data(), head.size());
+            
+            for (size_t i = 0; i < stream.size(); i += MAX_CHUNK) {
+                putChunk(file, "IDAT", stream.data() + i, std::min(stream.size() - i, MAX_CHUNK));
+            }
+            
+            putChunk(file, "IEND", nullptr, 0);
+            return file;
+        }
+        
+        void saveImage(const rgbaImage& image, const std::string& filename) {
+            const std::string PNG_EXTENSION = ".png";
+            const bool IS_PNG = (filename.size() >= PNG_EXTENSION.size() &&
+                                 0 == filename.compare(filename.size() - PNG_EXTENSION.size(), PNG_EXTENSION.size(), PNG_EXTENSION));
+            
+            const std::vector <uint8_t> FILE = (IS_PNG ? encodePng(image) : encodePpm(image));
+            
+            if (!fdl::fileUtil::writeFileAtomically(filename, FILE.data(), FILE.size())) {
+                throw fdl::errorUtil::fileWriteError("ERROR: Failed to write image file " + filename + '.');
+            }
+        }
+    }
+}
\ No newline at end of file
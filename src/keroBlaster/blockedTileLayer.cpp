@@ -0,0 +1,397 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include <cstdint>
+#include <cstring> //memcpy(void* dest, const void* src, size_t count), memset(...)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/blockedTileLayer.hpp"
+
+#include "fdl/containerUtil/arrayView.hpp"
+#include "fdl/containerUtil/byteKernels.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        namespace {
+            //stands in for null blocks in views and comparisons
+            const uint8_t ZERO_BLOCK [1 << (blockedTileLayer::LARGE_BLOCK_SHIFT * 2)] = {0};
+        }
+        
+        constexpr int blockedTileLayer::SMALL_BLOCK_SHIFT;
+        constexpr int blockedTileLayer::LARGE_BLOCK_SHIFT;
+        
+        blockedTileLayer::blockedTileLayer(const int blockShift) : width(0), height(0), flag(0), blockShift(blockShift),
+                                                                   blockColumns(0), blockRows(0) {
+            if (SMALL_BLOCK_SHIFT != blockShift && LARGE_BLOCK_SHIFT != blockShift) {
+                throw std::invalid_argument("ERROR: Attempt to create a blocked tile layer with blocks 2^" +
+                                            std::to_string(blockShift) + " tiles wide.");
+            }
+        }
+        
+        blockedTileLayer::blockedTileLayer(const pxPack::tileLayer& layer, const int blockShift) : blockedTileLayer(blockShift) {
+            setTiles(layer.getWidth(), layer.getHeight(), layer.getTileView().data());
+            flag = layer.getFlag();
+        }
+        
+        blockedTileLayer::blockedTileLayer(const blockedTileLayer& other) : width(other.width), height(other.height),
+                                                                            flag(other.flag), blockShift(other.blockShift),
+                                                                            blockColumns(other.blockColumns),
+                                                                            blockRows(other.blockRows),
+                                                                            blocks(other.blocks.size()) {
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                if (other.blocks[i]) {
+                    blocks[i].reset(new uint8_t [getBlockSize()]);
+                    memcpy(blocks[i].get(), other.blocks[i].get(), getBlockSize());
+                }
+            }
+        }
+        
+        blockedTileLayer& blockedTileLayer::operator=(const blockedTileLayer& other) {
+            if (this != &other) {
+                blockedTileLayer copy(other);
+                *this = std::move(copy);
+            }
+            
+            return *this;
+        }
+        
+        uint16_t blockedTileLayer::getWidth() const {
+            return width;
+        }
+        
+        uint16_t blockedTileLayer::getHeight() const {
+            return height;
+        }
+        
+        uint8_t blockedTileLayer::getFlag() const {
+            return flag;
+        }
+        
+        std::vector <uint8_t> blockedTileLayer::getTiles() const {
+            std::vector <uint8_t> tiles((size_t)width * height);
+            readRegion(0, 0, width, height, tiles.data());
+            return tiles;
+        }
+        
+        uint8_t blockedTileLayer::getTile(const uint16_t x, const uint16_t y) const {
+            if (x >= width || y >= height) {
+                throw std::out_of_range("ERROR: Attempt to get tile (" + std::to_string(x) + ", " + std::to_string(y) +
+                                        ") of a " + std::to_string(width) + 'x' + std::to_string(height) + " tile layer.");
+            }
+            
+            const uint8_t* const BLOCK = blocks[(y >> blockShift) * blockColumns + (x >> blockShift)].get();
+            const int MASK = (1 << blockShift) - 1;
+            
+            return (BLOCK ? BLOCK[((y & MASK) << blockShift) + (x & MASK)] : 0);
+        }
+        
+        void blockedTileLayer::copyTo(pxPack::tileLayer& layer) const {
+            const std::vector <uint8_t> TILES = getTiles();
+            layer.setTiles(width, height, TILES.data());
+            layer.setFlag(flag);
+        }
+        
+        void blockedTileLayer::reset() {
+            width = 0;
+            height = 0;
+            flag = 0;
+            blockColumns = 0;
+            blockRows = 0;
+            blocks.clear();
+        }
+        
+        void blockedTileLayer::setDimensions(const uint16_t width, const uint16_t height) {
+            const size_t BLOCK_WIDTH = (size_t)1 << blockShift;
+            const size_t NEW_COLUMNS = ((size_t)width + BLOCK_WIDTH - 1) >> blockShift;
+            const size_t NEW_ROWS = ((size_t)height + BLOCK_WIDTH - 1) >> blockShift;
+            
+            //only block pointers move; tiles stay where they are
+            if (NEW_COLUMNS != blockColumns || NEW_ROWS != blockRows) {
+                std::vector <std::unique_ptr <uint8_t []>> resized(NEW_COLUMNS * NEW_ROWS);
+                
+                for (size_t i = 0; i < std::min(NEW_ROWS, blockRows); ++i) {
+                    for (size_t j = 0; j < std::min(NEW_COLUMNS, blockColumns); ++j) {
+                        resized[i * NEW_COLUMNS + j] = std::move(blocks[i * blockColumns + j]);
+                    }
+                }
+                
+                blocks.swap(resized);
+                blockColumns = NEW_COLUMNS;
+                blockRows = NEW_ROWS;
+            }
+            
+            //tiles cut off along the new edges must read as 0 if the layer grows again
+            const size_t KEPT_WIDTH = width & (BLOCK_WIDTH - 1);
+            const size_t KEPT_HEIGHT = height & (BLOCK_WIDTH - 1);
+            
+            if (width < this -> width && KEPT_WIDTH > 0) {
+                for (size_t i = 0; i < blockRows; ++i) {
+                    uint8_t* const BLOCK = blocks[i * blockColumns + blockColumns - 1].get();
+                    
+                    for (size_t j = 0; BLOCK && j < BLOCK_WIDTH; ++j) {
+                        memset(BLOCK + (j << blockShift) + KEPT_WIDTH, 0, BLOCK_WIDTH - KEPT_WIDTH);
+                    }
+                }
+            }
+            
+            if (height < this -> height && KEPT_HEIGHT > 0) {
+                for (size_t j = 0; j < blockColumns; ++j) {
+                    uint8_t* const BLOCK = blocks[(blockRows - 1) * blockColumns + j].get();
+                    
+                    if (BLOCK) {
+                        memset(BLOCK + (KEPT_HEIGHT << blockShift), 0, (BLOCK_WIDTH - KEPT_HEIGHT) << blockShift);
+                    }
+                }
+            }
+            
+            this -> width = width;
+            this -> height = height;
+        }
+        
+        void blockedTileLayer::setFlag(const uint8_t flag) {
+            this -> flag = flag;
+        }
+        
+        void blockedTileLayer::setTile(const uint16_t x, const uint16_t y, const uint8_t tile) {
+            if (x >= width || y >= height) {
+                throw std::out_of_range("ERROR: Attempt to set tile (" + std::to_string(x) + ", " + std::to_string(y) +
+                                        ") of a " + std::to_string(width) + 'x' + std::to_string(height) + " tile layer.");
+            }
+            
+            const size_t BLOCK_X = x >> blockShift;
+            const size_t BLOCK_Y = y >> blockShift;
+            
+            if (0 == tile && !blocks[BLOCK_Y * blockColumns + BLOCK_X]) {
+                return; //null blocks are already all 0s
+            }
+            
+            const int MASK = (1 << blockShift) - 1;
+            getWritableBlock(BLOCK_X, BLOCK_Y)[((y & MASK) << blockShift) + (x & MASK)] = tile;
+        }
+        
+        void blockedTileLayer::setTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles) {
+            blocks.clear(); //cleared first so setDimensions() keeps nothing
+            blockColumns = 0;
+            blockRows = 0;
+            this -> width = 0;
+            this -> height = 0;
+            
+            setDimensions(width, height);
+            writeRegion(0, 0, width, height, tiles);
+        }
+        
+        void blockedTileLayer::readRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                          uint8_t* destination) const {
+            checkRegion(x, y, width, height, "read");
+            
+            forEachRun(x, y, width, height, [&](const size_t block, const size_t blockOffset, const size_t regionOffset,
+                                                const size_t length) {
+                const uint8_t* const BLOCK = blocks[block].get();
+                
+                if (BLOCK) {
+                    memcpy(destination + regionOffset, BLOCK + blockOffset, length);
+                }
+                else {
+                    memset(destination + regionOffset, 0, length);
+                }
+            });
+        }
+        
+        void blockedTileLayer::writeRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                           const uint8_t* source) {
+            checkRegion(x, y, width, height, "write");
+            
+            forEachRun(x, y, width, height, [&](const size_t block, const size_t blockOffset, const size_t regionOffset,
+                                                const size_t length) {
+                if (!blocks[block]) {
+                    //leave blocks of 0s unallocated
+                    if (std::all_of(source + regionOffset, source + regionOffset + length, [](const uint8_t TILE) {
+                        return 0 == TILE;
+                    })) {
+                        return;
+                    }
+                    
+                    getWritableBlock(block % blockColumns, block / blockColumns);
+                }
+                
+                memcpy(blocks[block].get() + blockOffset, source + regionOffset, length);
+            });
+        }
+        
+        int blockedTileLayer::getBlockShift() const {
+            return blockShift;
+        }
+        
+        size_t blockedTileLayer::getBlockColumns() const {
+            return blockColumns;
+        }
+        
+        size_t blockedTileLayer::getBlockRows() const {
+            return blockRows;
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> blockedTileLayer::getBlockView(const size_t blockX, const size_t blockY) const {
+            if (blockX >= blockColumns || blockY >= blockRows) {
+                throw std::out_of_range("ERROR: Attempt to view block (" + std::to_string(blockX) + ", " + std::to_string(blockY) +
+                                        ") of a tile layer " + std::to_string(blockColumns) + 'x' + std::to_string(blockRows) +
+                                        " blocks in size.");
+            }
+            
+            const uint8_t* const BLOCK = blocks[blockY * blockColumns + blockX].get();
+            return fdl::containerUtil::arrayView <const uint8_t>((BLOCK ? BLOCK : ZERO_BLOCK), getBlockSize());
+        }
+        
+        size_t blockedTileLayer::getNumAllocatedBlocks() const {
+            return std::count_if(blocks.begin(), blocks.end(), [](const std::unique_ptr <uint8_t []>& BLOCK) {
+                return nullptr != BLOCK;
+            });
+        }
+        
+        void blockedTileLayer::fillRect(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                        const uint8_t tile) {
+            checkRegion(x, y, width, height, "fill");
+            
+            forEachRun(x, y, width, height, [&](const size_t block, const size_t blockOffset, const size_t,
+                                                const size_t length) {
+                if (0 == tile && !blocks[block]) {
+                    return;
+                }
+                
+                memset(getWritableBlock(block % blockColumns, block / blockColumns) + blockOffset, tile, length);
+            });
+        }
+        
+        size_t blockedTileLayer::replaceTile(const uint8_t from, const uint8_t to) {
+            if (from == to) {
+                return getHistogram()[from];
+            }
+            
+            size_t count = 0;
+            
+            if (0 != from) {
+                //0s outside the layer are never replaced, so whole blocks can be scanned
+                for (std::unique_ptr <uint8_t []>& block : blocks) {
+                    if (block) {
+                        count += fdl::containerUtil::replaceBytes(block.get(), getBlockSize(), from, to);
+                    }
+                }
+                
+                return count;
+            }
+            
+            forEachRun(0, 0, width, height, [&](const size_t block, const size_t blockOffset, const size_t,
+                                                const size_t length) {
+                uint8_t* const BLOCK = getWritableBlock(block % blockColumns, block / blockColumns);
+                count += fdl::containerUtil::replaceBytes(BLOCK + blockOffset, length, from, to);
+            });
+            
+            return count;
+        }
+        
+        std::array <size_t, 256> blockedTileLayer::getHistogram() const {
+            std::array <size_t, 256> histogram = {};
+            
+            for (const std::unique_ptr <uint8_t []>& BLOCK : blocks) {
+                if (BLOCK) {
+                    fdl::containerUtil::countBytes(BLOCK.get(), getBlockSize(), histogram);
+                }
+                else {
+                    histogram[0] += getBlockSize();
+                }
+            }
+            
+            histogram[0] -= blocks.size() * getBlockSize() - (size_t)width * height; //tiles outside the layer are all 0s
+            
+            return histogram;
+        }
+        
+        size_t blockedTileLayer::countDifferences(const blockedTileLayer& other) const {
+            if (width != other.width || height != other.height) {
+                throw std::invalid_argument("ERROR: Attempt to compare a " + std::to_string(width) + 'x' + std::to_string(height) +
+                                            " tile layer with a " + std::to_string(other.width) + 'x' +
+                                            std::to_string(other.height) + " tile layer.");
+            }
+            
+            if (blockShift != other.blockShift) {
+                const std::vector <uint8_t> TILES = getTiles();
+                const std::vector <uint8_t> OTHER_TILES = other.getTiles();
+                return fdl::containerUtil::countDifferentBytes(TILES.data(), OTHER_TILES.data(), TILES.size());
+            }
+            
+            size_t count = 0;
+            
+            //tiles outside the layer are 0 in both, so whole blocks can be compared
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                if (blocks[i] || other.blocks[i]) {
+                    count += fdl::containerUtil::countDifferentBytes((blocks[i] ? blocks[i].get() : ZERO_BLOCK),
+                                                                     (other.blocks[i] ? other.blocks[i].get() : ZERO_BLOCK),
+                                                                     getBlockSize());
+                }
+            }
+            
+            return count;
+        }
+        
+        size_t blockedTileLayer::getBlockSize() const {
+            return (size_t)1 << (blockShift * 2);
+        }
+        
+        uint8_t* blockedTileLayer::getWritableBlock(const size_t blockX, const size_t blockY) {
+            std::unique_ptr <uint8_t []>& block = blocks[blockY * blockColumns + blockX];
+            
+            if (!block) {
+                block.reset(new uint8_t [getBlockSize()]());
+            }
+            
+            return block.get();
+        }
+        
+        void blockedTileLayer::checkRegion(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                           const std::string& action) const {
+            if ((size_t)x + width > this -> width || (size_t)y + height > this -> height) {
+                throw std::out_of_range("ERROR: Attempt to " + action + ' ' + std::to_string(width) + 'x' +
+                                        std::to_string(height) + " rectangle at (" + std::to_string(x) + ", " +
+                                        std::to_string(y) + ") of a " + std::to_string(this -> width) + 'x' +
+                                        std::to_string(this -> height) + " tile layer.");
+            }
+        }
+        
+        template <typename F>
+        void blockedTileLayer::forEachRun(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                          F f) const {
+            if (0 == width || 0 == height) {
+                return;
+            }
+            
+            const size_t MASK = ((size_t)1 << blockShift) - 1;
+            const size_t RIGHT = (size_t)x + width; //exclusive
+            const size_t BOTTOM = (size_t)y + height;
+            
+            for (size_t blockY = y >> blockShift; blockY <= (BOTTOM - 1) >> blockShift; ++blockY) {
+                const size_t TOP_ROW = std::max((size_t)y, blockY << blockShift);
+                const size_t END_ROW = std::min(BOTTOM, (blockY + 1) << blockShift);
+                
+                for (size_t blockX = x >> blockShift; blockX <= (RIGHT - 1) >> blockShift; ++blockX) {
+                    const size_t LEFT_COLUMN = std::max((size_t)x, blockX << blockShift);
+                    const size_t LENGTH = std::min(RIGHT, (blockX + 1) << blockShift) - LEFT_COLUMN;
+                    const size_t BLOCK = blockY * blockColumns + blockX;
+                    
+                    if (LENGTH == MASK + 1 && width == LENGTH) { //block-aligned rectangles one block wide are contiguous on both sides
+                        f(BLOCK, (TOP_ROW & MASK) << blockShift, (TOP_ROW - y) * width, (END_ROW - TOP_ROW) * LENGTH);
+                        continue;
+                    }
+                    
+                    for (size_t row = TOP_ROW; row < END_ROW; ++row) {
+                        f(BLOCK, ((row & MASK) << blockShift) + (LEFT_COLUMN & MASK),
+                          (row - y) * width + (LEFT_COLUMN - x), LENGTH);
+                    }
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
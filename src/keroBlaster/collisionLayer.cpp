@@ -0,0 +1,311 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib> //abs(long long n)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/collisionLayer.hpp"
+
+#include "fdl/containerUtil/containerUtil.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        namespace {
+            /**
+             * Clips the span [start, start + length) to [0, limit).
+             */
+            void clipSpan(const int64_t start, const int64_t length, const uint16_t limit, uint16_t& first, uint16_t& end) {
+                first = std::min <int64_t>(std::max <int64_t>(start, 0), limit);
+                end = std::max <int64_t>(std::min <int64_t>(start + length, limit), first);
+            }
+            
+            /**
+             * @return bitsPerCell, if a collision layer can pack cells of that size.
+             */
+            int checkBitsPerCell(const int bitsPerCell) {
+                if (bitsPerCell < 1 || bitsPerCell > collisionLayer::MAX_BITS_PER_CELL) {
+                    throw std::invalid_argument("ERROR: Attempt to create a collision layer with " + std::to_string(bitsPerCell) +
+                                                " bits per cell.");
+                }
+                
+                return bitsPerCell;
+            }
+        }
+        
+        constexpr int collisionLayer::MAX_BITS_PER_CELL;
+        
+        collisionLayer::collisionLayer(pxPack::tileLayer& layer, const std::array <uint8_t, 256>& attributes,
+                                       const int bitsPerCell) : layer(&layer),
+                                                                bitsPerCell(checkBitsPerCell(bitsPerCell)), //before slotBits and cellShift use it
+                                                                slotBits((3 == bitsPerCell) ? 4 : bitsPerCell), laneOnes(0),
+                                                                cellShift(__builtin_ctz(64 / slotBits)),
+                                                                attributes(attributes), width(0), height(0), wordsPerRow(0) {
+            checkAttributes(attributes);
+            
+            if (layer.collision) {
+                throw std::logic_error("ERROR: Attempt to attach a second collision layer to a tile layer.");
+            }
+            
+            laneOnes = ~(uint64_t)0 / (((uint64_t)1 << slotBits) - 1);
+            
+            layer.collision = this;
+            rebuild();
+        }
+        
+        collisionLayer::~collisionLayer() {
+            if (layer) {
+                layer -> collision = nullptr;
+            }
+        }
+        
+        int collisionLayer::getBitsPerCell() const {
+            return bitsPerCell;
+        }
+        
+        const std::array <uint8_t, 256>& collisionLayer::getAttributes() const {
+            return attributes;
+        }
+        
+        void collisionLayer::setAttributes(const std::array <uint8_t, 256>& attributes) {
+            checkAttributes(attributes);
+            this -> attributes = attributes;
+            rebuild();
+        }
+        
+        uint8_t collisionLayer::getCell(const uint16_t x, const uint16_t y) const {
+            checkAttached();
+            
+            if (x >= width || y >= height) {
+                throw std::out_of_range("ERROR: Attempt to get cell (" + std::to_string(x) + ", " + std::to_string(y) +
+                                        ") of a " + std::to_string(width) + 'x' + std::to_string(height) + " collision layer.");
+            }
+            
+            const uint64_t WORD = words[y * wordsPerRow + (x >> cellShift)];
+            return (WORD >> ((x & getCellMask()) * slotBits)) & ((1 << slotBits) - 1);
+        }
+        
+        bool collisionLayer::anyInRect(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                       const uint8_t mask) const {
+            checkAttached();
+            
+            uint16_t firstColumn, endColumn, firstRow, endRow;
+            clipSpan(x, width, this -> width, firstColumn, endColumn);
+            clipSpan(y, height, this -> height, firstRow, endRow);
+            
+            for (uint16_t row = firstRow; row < endRow; ++row) {
+                if (scanRow(row, firstColumn, endColumn, mask, false, [](const size_t, const uint64_t MATCHES) {
+                    return (0 != MATCHES);
+                })) {
+                    return true;
+                }
+            }
+            
+            return false;
+        }
+        
+        size_t collisionLayer::countInRect(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                           const uint8_t mask) const {
+            checkAttached();
+            
+            uint16_t firstColumn, endColumn, firstRow, endRow;
+            clipSpan(x, width, this -> width, firstColumn, endColumn);
+            clipSpan(y, height, this -> height, firstRow, endRow);
+            
+            size_t count = 0;
+            
+            for (uint16_t row = firstRow; row < endRow; ++row) {
+                scanRow(row, firstColumn, endColumn, mask, false, [&count](const size_t, const uint64_t MATCHES) {
+                    count += __builtin_popcountll(MATCHES);
+                    return false;
+                });
+            }
+            
+            return count;
+        }
+        
+        uint32_t collisionLayer::sweepHorizontal(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                                 const int32_t dx, const uint8_t mask) const {
+            checkAttached();
+            
+            const int64_t DISTANCE = std::abs((int64_t)dx);
+            
+            if (0 == width || 0 == height) {
+                return DISTANCE;
+            }
+            
+            //the columns the box moves into, and the one next to the box that each distance is measured from
+            const int64_t START = ((dx > 0) ? (int64_t)x + width : (int64_t)x - DISTANCE);
+            const int64_t EDGE = ((dx > 0) ? (int64_t)x + width : (int64_t)x - 1);
+            
+            uint16_t firstColumn, endColumn, firstRow, endRow;
+            clipSpan(START, DISTANCE, this -> width, firstColumn, endColumn);
+            clipSpan(y, height, this -> height, firstRow, endRow);
+            
+            int64_t allowed = DISTANCE;
+            
+            //each row stops at its nearest matching cell, and the box stops at the nearest of those
+            for (uint16_t row = firstRow; row < endRow && allowed > 0; ++row) {
+                scanRow(row, firstColumn, endColumn, mask, dx < 0, [&](const size_t WORD_INDEX, const uint64_t MATCHES) {
+                    if (0 == MATCHES) {
+                        return false;
+                    }
+                    
+                    const int BIT = ((dx > 0) ? __builtin_ctzll(MATCHES) : 63 - __builtin_clzll(MATCHES));
+                    const int64_t COLUMN = (WORD_INDEX << cellShift) + (BIT >> (6 - cellShift)); //slotBits is 2^(6 - cellShift)
+                    
+                    allowed = std::min(allowed, ((dx > 0) ? COLUMN - EDGE : EDGE - COLUMN));
+                    return true;
+                });
+            }
+            
+            return allowed;
+        }
+        
+        uint32_t collisionLayer::sweepVertical(const int32_t x, const int32_t y, const uint32_t width, const uint32_t height,
+                                               const int32_t dy, const uint8_t mask) const {
+            checkAttached();
+            
+            const int64_t DISTANCE = std::abs((int64_t)dy);
+            
+            if (0 == width || 0 == height) {
+                return DISTANCE;
+            }
+            
+            const int64_t START = ((dy > 0) ? (int64_t)y + height : (int64_t)y - DISTANCE);
+            const int64_t EDGE = ((dy > 0) ? (int64_t)y + height : (int64_t)y - 1);
+            
+            uint16_t firstColumn, endColumn, firstRow, endRow;
+            clipSpan(x, width, this -> width, firstColumn, endColumn);
+            clipSpan(START, DISTANCE, this -> height, firstRow, endRow);
+            
+            const auto ANY = [](const size_t, const uint64_t MATCHES) {
+                return (0 != MATCHES);
+            };
+            
+            //rows are checked from the box outwards, so the first one holding a match stops it
+            for (int64_t i = 0; i < endRow - firstRow; ++i) {
+                const uint16_t ROW = ((dy > 0) ? firstRow + i : endRow - 1 - i);
+                
+                if (scanRow(ROW, firstColumn, endColumn, mask, false, ANY)) {
+                    return ((dy > 0) ? ROW - EDGE : EDGE - ROW);
+                }
+            }
+            
+            return DISTANCE;
+        }
+        
+        void collisionLayer::rebuild() {
+            checkAttached();
+            
+            width = layer -> getWidth();
+            height = layer -> getHeight();
+            
+            wordsPerRow = ((size_t)width + getCellMask()) >> cellShift;
+            words.assign(wordsPerRow * height, 0);
+            
+            rebuildRows(0, height);
+        }
+        
+        void collisionLayer::checkAttached() const {
+            if (!layer) {
+                throw std::logic_error("ERROR: Attempt to use a collision layer whose tile layer was destroyed.");
+            }
+        }
+        
+        void collisionLayer::checkAttributes(const std::array <uint8_t, 256>& attributes) const {
+            for (size_t i = 0; i < attributes.size(); ++i) {
+                if (0 != (attributes[i] >> bitsPerCell)) {
+                    throw std::invalid_argument("ERROR: Attempt to give tile " + std::to_string(i) + " attribute " +
+                                                std::to_string(attributes[i]) + " in a collision layer with " +
+                                                std::to_string(bitsPerCell) + " bits per cell.");
+                }
+            }
+        }
+        
+        size_t collisionLayer::getCellMask() const {
+            return ((size_t)1 << cellShift) - 1;
+        }
+        
+        void collisionLayer::update(const size_t index, const uint8_t tile) {
+            const size_t X = index % width;
+            const int SHIFT = (X & getCellMask()) * slotBits;
+            
+            uint64_t& word = words[(index / width) * wordsPerRow + (X >> cellShift)];
+            word = (word & ~((((uint64_t)1 << slotBits) - 1) << SHIFT)) | ((uint64_t)attributes[tile] << SHIFT);
+        }
+        
+        void collisionLayer::rebuildRows(const uint16_t firstRow, const uint16_t endRow) {
+            const size_t CELLS_PER_WORD = (size_t)1 << cellShift;
+            const uint8_t* const TILES = layer -> getTileView().data();
+            
+            for (size_t y = firstRow; y < endRow; ++y) {
+                const uint8_t* const ROW_TILES = TILES + fdl::containerUtil::indexFromCoords(0, y, width);
+                uint64_t* const ROW = words.data() + y * wordsPerRow;
+                
+                //each word is filled from its last cell back, so every cell is shifted into place as the next is added
+                for (size_t i = 0; i < wordsPerRow; ++i) {
+                    const size_t FIRST = i * CELLS_PER_WORD;
+                    uint64_t word = 0;
+                    
+                    for (size_t x = std::min(FIRST + CELLS_PER_WORD, (size_t)width); x > FIRST; --x) {
+                        word = (word << slotBits) | attributes[ROW_TILES[x - 1]];
+                    }
+                    
+                    ROW[i] = word;
+                }
+            }
+        }
+        
+        uint64_t collisionLayer::matchCells(const uint64_t word, const uint8_t mask) const {
+            uint64_t matches = word & (laneOnes * (mask & ((1 << slotBits) - 1)));
+            
+            //fold each slot's bits down into its lowest bit; bits shifted in from the next slot only reach higher bits
+            for (int shift = 1; shift < slotBits; shift <<= 1) {
+                matches |= matches >> shift;
+            }
+            
+            return matches & laneOnes;
+        }
+        
+        template <typename F>
+        bool collisionLayer::scanRow(const uint16_t y, const uint16_t first, const uint16_t end, const uint8_t mask,
+                                     const bool fromRight, F f) const {
+            if (first >= end) {
+                return false;
+            }
+            
+            const size_t FIRST_WORD = first >> cellShift;
+            const size_t LAST_WORD = (end - 1) >> cellShift;
+            const uint64_t* const ROW = words.data() + y * wordsPerRow;
+            
+            const uint64_t FIRST_MASK = ~(uint64_t)0 << ((first & getCellMask()) * slotBits);
+            const size_t END_BIT = (((end - 1) & getCellMask()) + 1) * slotBits;
+            const uint64_t LAST_MASK = ((END_BIT < 64) ? ((uint64_t)1 << END_BIT) - 1 : ~(uint64_t)0);
+            
+            for (size_t i = 0; i <= LAST_WORD - FIRST_WORD; ++i) {
+                const size_t WORD_INDEX = (fromRight ? LAST_WORD - i : FIRST_WORD + i);
+                uint64_t matches = matchCells(ROW[WORD_INDEX], mask);
+                
+                if (FIRST_WORD == WORD_INDEX) {
+                    matches &= FIRST_MASK;
+                }
+                
+                if (LAST_WORD == WORD_INDEX) {
+                    matches &= LAST_MASK;
+                }
+                
+                if (f(WORD_INDEX, matches)) {
+                    return true;
+                }
+            }
+            
+            return false;
+        }
+    }
+}
\ No newline at end of file
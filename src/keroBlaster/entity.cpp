@@ -35,11 +35,11 @@ namespace fdl {
             return y;
         }
         
-        std::array <uint8_t, pxPack::NUM_UNKNOWN_ENTITY_BYTES> pxPack::entity::getData() const {
+        const std::array <uint8_t, pxPack::NUM_UNKNOWN_ENTITY_BYTES>& pxPack::entity::getData() const {
             return data;
         }
         
-        std::string pxPack::entity::getName() const {
+        const std::string& pxPack::entity::getName() const {
             return name;
         }
         
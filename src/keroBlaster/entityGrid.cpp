@@ -0,0 +1,234 @@
+#include <vector>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/entityGrid.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        constexpr int entityGrid::DEFAULT_CELL_SHIFT;
+        constexpr int entityGrid::MAX_CELL_SHIFT;
+        constexpr size_t entityGrid::MAX_NUM_CELLS;
+        
+        entityGrid::entityGrid(pxPack::entityTable& table, const int cellShift) : table(&table), requestedCellShift(cellShift),
+                                                                                  cellShift(cellShift), columns(0), rows(0) {
+            if (cellShift < 0 || cellShift > MAX_CELL_SHIFT) {
+                throw std::invalid_argument("ERROR: Attempt to create an entity grid with cells 2^" +
+                                            std::to_string(cellShift) + " wide.");
+            }
+            
+            if (table.grid) {
+                throw std::logic_error("ERROR: Attempt to attach a second entity grid to an entity table.");
+            }
+            
+            table.grid = this;
+            rebuild();
+        }
+        
+        entityGrid::~entityGrid() {
+            if (table) {
+                table -> grid = nullptr;
+            }
+        }
+        
+        int entityGrid::getCellShift() const {
+            return cellShift;
+        }
+        
+        void entityGrid::findInRect(const uint16_t x, const uint16_t y, const uint32_t width, const uint32_t height,
+                                    std::vector <size_t>& results) const {
+            checkAttached();
+            
+            if (0 == width || 0 == height) {
+                return;
+            }
+            
+            const uint32_t RIGHT = x + width; //exclusive
+            const uint32_t BOTTOM = y + height;
+            
+            const size_t FIRST_COLUMN = x >> cellShift;
+            const size_t FIRST_ROW = y >> cellShift;
+            const size_t LAST_COLUMN = std::min <size_t>((RIGHT - 1) >> cellShift, columns - 1);
+            const size_t LAST_ROW = std::min <size_t>((BOTTOM - 1) >> cellShift, rows - 1);
+            
+            const uint16_t* const XS = table -> xs.data();
+            const uint16_t* const YS = table -> ys.data();
+            
+            for (size_t row = FIRST_ROW; row <= LAST_ROW; ++row) {
+                for (size_t column = FIRST_COLUMN; column <= LAST_COLUMN; ++column) {
+                    for (const uint16_t INDEX : cells[row * columns + column]) {
+                        if (XS[INDEX] >= x && XS[INDEX] < RIGHT && YS[INDEX] >= y && YS[INDEX] < BOTTOM) {
+                            results.push_back(INDEX);
+                        }
+                    }
+                }
+            }
+        }
+        
+        bool entityGrid::findNearest(const uint16_t x, const uint16_t y, const uint8_t type, size_t& index) const {
+            checkAttached();
+            
+            if (table -> empty()) {
+                return false;
+            }
+            
+            //start from the cell nearest the point, which may be outside the grid
+            const size_t HOME_COLUMN = std::min <size_t>(x >> cellShift, columns - 1);
+            const size_t HOME_ROW = std::min <size_t>(y >> cellShift, rows - 1);
+            const size_t MAX_RING = std::max(std::max(HOME_COLUMN, columns - 1 - HOME_COLUMN),
+                                             std::max(HOME_ROW, rows - 1 - HOME_ROW));
+            
+            const uint16_t* const XS = table -> xs.data();
+            const uint16_t* const YS = table -> ys.data();
+            const uint8_t* const TYPES = table -> types.data();
+            
+            bool found = false;
+            uint64_t bestDistance = 0;
+            
+            const auto SCAN_CELL = [&](const int64_t column, const int64_t row) {
+                if (column < 0 || row < 0 || column >= (int64_t)columns || row >= (int64_t)rows) {
+                    return;
+                }
+                
+                for (const uint16_t CANDIDATE : cells[row * columns + column]) {
+                    if (type != TYPES[CANDIDATE]) {
+                        continue;
+                    }
+                    
+                    const int64_t DX = (int64_t)XS[CANDIDATE] - x;
+                    const int64_t DY = (int64_t)YS[CANDIDATE] - y;
+                    const uint64_t DISTANCE = DX * DX + DY * DY;
+                    
+                    if (!found || DISTANCE < bestDistance || (DISTANCE == bestDistance && CANDIDATE < index)) {
+                        found = true;
+                        bestDistance = DISTANCE;
+                        index = CANDIDATE;
+                    }
+                }
+            };
+            
+            for (size_t ring = 0; ring <= MAX_RING; ++ring) {
+                //every entity in this ring is at least (ring - 1) cells away along one axis
+                if (found && ring > 0) {
+                    const uint64_t MIN_DISTANCE = (uint64_t)(ring - 1) << cellShift;
+                    
+                    if (MIN_DISTANCE * MIN_DISTANCE > bestDistance) {
+                        break;
+                    }
+                }
+                
+                const int64_t LEFT = (int64_t)HOME_COLUMN - ring;
+                const int64_t RIGHT = (int64_t)HOME_COLUMN + ring;
+                const int64_t TOP = (int64_t)HOME_ROW - ring;
+                const int64_t BOTTOM = (int64_t)HOME_ROW + ring;
+                
+                for (int64_t column = LEFT; column <= RIGHT; ++column) {
+                    SCAN_CELL(column, TOP);
+                    
+                    if (ring > 0) {
+                        SCAN_CELL(column, BOTTOM);
+                    }
+                }
+                
+                for (int64_t row = TOP + 1; row < BOTTOM; ++row) {
+                    SCAN_CELL(LEFT, row);
+                    SCAN_CELL(RIGHT, row);
+                }
+            }
+            
+            return found;
+        }
+        
+        void entityGrid::rebuild() {
+            resize(0, 0);
+        }
+        
+        void entityGrid::checkAttached() const {
+            if (!table) {
+                throw std::logic_error("ERROR: Attempt to query an entity grid whose entity table has been destroyed.");
+            }
+        }
+        
+        size_t entityGrid::getCellIndex(const uint16_t x, const uint16_t y) const {
+            return (size_t)(y >> cellShift) * columns + (x >> cellShift);
+        }
+        
+        void entityGrid::insert(const size_t index) {
+            const size_t COLUMN = table -> xs[index] >> cellShift;
+            const size_t ROW = table -> ys[index] >> cellShift;
+            
+            if (COLUMN >= columns || ROW >= rows) {
+                //grow geometrically so entities drifting outward don't rebuild the grid on every step
+                resize(std::max(COLUMN + 1, columns * 2), std::max(ROW + 1, rows * 2));
+                return;
+            }
+            
+            std::vector <uint16_t>& cell = cells[ROW * columns + COLUMN];
+            
+            slots.resize(table -> size());
+            slots[index] = cell.size();
+            cell.push_back(index);
+        }
+        
+        void entityGrid::move(const size_t index, const uint16_t oldX, const uint16_t oldY) {
+            const size_t OLD_CELL = getCellIndex(oldX, oldY);
+            
+            if ((oldX >> cellShift) == (table -> xs[index] >> cellShift) &&
+                (oldY >> cellShift) == (table -> ys[index] >> cellShift)) {
+                return; //still in the same cell
+            }
+            
+            removeFromCell(index, OLD_CELL);
+            insert(index);
+        }
+        
+        void entityGrid::removeFromCell(const size_t index, const size_t cell) {
+            std::vector <uint16_t>& entities = cells[cell];
+            
+            //swap the last entity in the cell into the removed one's place
+            const uint16_t LAST = entities.back();
+            entities[slots[index]] = LAST;
+            slots[LAST] = slots[index];
+            entities.pop_back();
+        }
+        
+        void entityGrid::resize(const size_t minColumns, const size_t minRows) {
+            const size_t NUM_ENTITIES = table -> size();
+            
+            uint16_t maxX = 0, maxY = 0;
+            
+            for (size_t i = 0; i < NUM_ENTITIES; ++i) {
+                maxX = std::max(maxX, table -> xs[i]);
+                maxY = std::max(maxY, table -> ys[i]);
+            }
+            
+            //start from the requested cell size, so cells widened for an entity that's since moved back narrow again
+            const int WIDENED = cellShift - requestedCellShift;
+            cellShift = requestedCellShift;
+            
+            const size_t MAX_SIDE = ((size_t)UINT16_MAX >> cellShift) + 1;
+            columns = std::min(std::max(minColumns << WIDENED, (size_t)(maxX >> cellShift) + 1), MAX_SIDE);
+            rows = std::min(std::max(minRows << WIDENED, (size_t)(maxY >> cellShift) + 1), MAX_SIDE);
+            
+            //an entity far from the rest would otherwise make a huge, mostly empty grid
+            while (columns * rows > MAX_NUM_CELLS) {
+                ++cellShift;
+                columns = (columns + 1) / 2;
+                rows = (rows + 1) / 2;
+            }
+            
+            cells.assign(columns * rows, std::vector <uint16_t>());
+            slots.resize(NUM_ENTITIES);
+            
+            for (size_t i = 0; i < NUM_ENTITIES; ++i) {
+                std::vector <uint16_t>& cell = cells[getCellIndex(table -> xs[i], table -> ys[i])];
+                slots[i] = cell.size();
+                cell.push_back(i);
+            }
+        }
+    }
+}
\ No newline at end of file
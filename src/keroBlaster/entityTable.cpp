@@ -0,0 +1,322 @@
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+
+#include <stdexcept>
+
+#include <cstdint>
+#include <cstring> //memcpy(void* destination, const void* source, size_t num)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/entityGrid.hpp"
+
+#include "fdl/containerUtil/arrayView.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        pxPack::entityTable::constEntityRef::constEntityRef(const entityTable* table, const size_t index) : table(table), index(index) {}
+        
+        pxPack::entityTable::entityRef::entityRef(entityTable* table, const size_t index) : constEntityRef(table, index),
+                                                                                           writableTable(table) {}
+        
+        uint8_t pxPack::entityTable::constEntityRef::getFlag() const {
+            return table -> flags[index];
+        }
+        
+        uint8_t pxPack::entityTable::constEntityRef::getType() const {
+            return table -> types[index];
+        }
+        
+        uint8_t pxPack::entityTable::constEntityRef::getUnknownByte() const {
+            return table -> unknownBytes[index];
+        }
+        
+        uint16_t pxPack::entityTable::constEntityRef::getX() const {
+            return table -> xs[index];
+        }
+        
+        uint16_t pxPack::entityTable::constEntityRef::getY() const {
+            return table -> ys[index];
+        }
+        
+        const std::array <uint8_t, pxPack::NUM_UNKNOWN_ENTITY_BYTES>& pxPack::entityTable::constEntityRef::getData() const {
+            return table -> data[index];
+        }
+        
+        std::string pxPack::entityTable::constEntityRef::getName() const {
+            return std::string(table -> names[index].data(), table -> nameLengths[index]);
+        }
+        
+        fdl::containerUtil::arrayView <const char> pxPack::entityTable::constEntityRef::getNameView() const {
+            return fdl::containerUtil::arrayView <const char>(table -> names[index].data(), table -> nameLengths[index]);
+        }
+        
+        pxPack::entity pxPack::entityTable::constEntityRef::toEntity() const {
+            entity ent;
+            
+            ent.setFlag(getFlag());
+            ent.setType(getType());
+            ent.setUnknownByte(getUnknownByte());
+            ent.setX(getX());
+            ent.setY(getY());
+            
+            for (int i = 0; i < NUM_UNKNOWN_ENTITY_BYTES; ++i) {
+                ent.setData(i, getData()[i]);
+            }
+            
+            ent.setName(getName());
+            
+            return ent;
+        }
+        
+        void pxPack::entityTable::entityRef::setFlag(const uint8_t flag) {
+            writableTable -> flags[index] = flag;
+        }
+        
+        void pxPack::entityTable::entityRef::setType(const uint8_t type) {
+            writableTable -> types[index] = type;
+        }
+        
+        void pxPack::entityTable::entityRef::setUnknownByte(const uint8_t unknownByte) {
+            writableTable -> unknownBytes[index] = unknownByte;
+        }
+        
+        void pxPack::entityTable::entityRef::setX(const uint16_t x) {
+            writableTable -> setPosition(index, x, writableTable -> ys[index]);
+        }
+        
+        void pxPack::entityTable::entityRef::setY(const uint16_t y) {
+            writableTable -> setPosition(index, writableTable -> xs[index], y);
+        }
+        
+        void pxPack::entityTable::entityRef::setData(const size_t index, const uint8_t data) {
+            writableTable -> data[this -> index].at(index) = data;
+        }
+        
+        void pxPack::entityTable::entityRef::setName(const std::string& name) {
+            writableTable -> setName(index, name);
+        }
+        
+        pxPack::entityTable::entityTable() : grid(nullptr) {}
+        
+        pxPack::entityTable::entityTable(const entityVector& entities) : grid(nullptr) {
+            assign(entities);
+        }
+        
+        pxPack::entityTable::entityTable(const entityTable& other) : flags(other.flags), types(other.types),
+                                                                     unknownBytes(other.unknownBytes), xs(other.xs),
+                                                                     ys(other.ys), data(other.data), names(other.names),
+                                                                     nameLengths(other.nameLengths), grid(nullptr) {}
+        
+        pxPack::entityTable& pxPack::entityTable::operator=(const entityTable& other) {
+            if (this != &other) {
+                flags = other.flags;
+                types = other.types;
+                unknownBytes = other.unknownBytes;
+                xs = other.xs;
+                ys = other.ys;
+                data = other.data;
+                names = other.names;
+                nameLengths = other.nameLengths;
+                
+                if (grid) {
+                    grid -> rebuild();
+                }
+            }
+            
+            return *this;
+        }
+        
+        pxPack::entityTable::entityTable(entityTable&& other) : flags(std::move(other.flags)), types(std::move(other.types)),
+                                                                unknownBytes(std::move(other.unknownBytes)),
+                                                                xs(std::move(other.xs)), ys(std::move(other.ys)),
+                                                                data(std::move(other.data)), names(std::move(other.names)),
+                                                                nameLengths(std::move(other.nameLengths)), grid(nullptr) {
+            other.clear();
+        }
+        
+        pxPack::entityTable& pxPack::entityTable::operator=(entityTable&& other) {
+            if (this != &other) {
+                flags = std::move(other.flags);
+                types = std::move(other.types);
+                unknownBytes = std::move(other.unknownBytes);
+                xs = std::move(other.xs);
+                ys = std::move(other.ys);
+                data = std::move(other.data);
+                names = std::move(other.names);
+                nameLengths = std::move(other.nameLengths);
+                
+                other.clear();
+                
+                if (grid) {
+                    grid -> rebuild();
+                }
+            }
+            
+            return *this;
+        }
+        
+        pxPack::entityTable::~entityTable() {
+            if (grid) {
+                grid -> table = nullptr;
+            }
+        }
+        
+        size_t pxPack::entityTable::size() const {
+            return flags.size();
+        }
+        
+        bool pxPack::entityTable::empty() const {
+            return flags.empty();
+        }
+        
+        void pxPack::entityTable::clear() {
+            flags.clear();
+            types.clear();
+            unknownBytes.clear();
+            xs.clear();
+            ys.clear();
+            data.clear();
+            names.clear();
+            nameLengths.clear();
+            
+            if (grid) {
+                grid -> rebuild();
+            }
+        }
+        
+        void pxPack::entityTable::reserve(const size_t count) {
+            if (count > MAX_NUM_ENTITIES) {
+                throw std::length_error("ERROR: Attempt to reserve space for more than " +
+                                        std::to_string(MAX_NUM_ENTITIES) + " entities.");
+            }
+            
+            flags.reserve(count);
+            types.reserve(count);
+            unknownBytes.reserve(count);
+            xs.reserve(count);
+            ys.reserve(count);
+            data.reserve(count);
+            names.reserve(count);
+            nameLengths.reserve(count);
+        }
+        
+        void pxPack::entityTable::push_back(const entity& ent) {
+            if (size() >= MAX_NUM_ENTITIES) {
+                throw std::length_error("ERROR: Attempt to store more than " +
+                                        std::to_string(MAX_NUM_ENTITIES) + " entities.");
+            }
+            
+            if (ent.getName().size() > entity::NAME_MAX_LEN) { //checked up front so a failed push leaves every column the same size
+                throw std::length_error("ERROR: Attempt to store an entity name longer than " +
+                                        std::to_string(entity::NAME_MAX_LEN) + " characters.");
+            }
+            
+            flags.push_back(ent.getFlag());
+            types.push_back(ent.getType());
+            unknownBytes.push_back(ent.getUnknownByte());
+            xs.push_back(ent.getX());
+            ys.push_back(ent.getY());
+            data.push_back(ent.getData());
+            names.emplace_back();
+            nameLengths.push_back(0);
+            
+            setName(size() - 1, ent.getName());
+            
+            if (grid) {
+                grid -> insert(size() - 1);
+            }
+        }
+        
+        void pxPack::entityTable::assign(const entityVector& entities) {
+            clear();
+            reserve(entities.size());
+            
+            for (const entity& ent : entities) {
+                push_back(ent);
+            }
+        }
+        
+        void pxPack::entityTable::copyTo(entityVector& entities) const {
+            entities.clear();
+            entities.reserve(size());
+            
+            for (size_t i = 0; i < size(); ++i) {
+                entities.push_back((*this)[i].toEntity());
+            }
+        }
+        
+        pxPack::entityTable::entityRef pxPack::entityTable::operator[](const size_t index) {
+            return entityRef(this, index);
+        }
+        
+        pxPack::entityTable::constEntityRef pxPack::entityTable::operator[](const size_t index) const {
+            return constEntityRef(this, index);
+        }
+        
+        pxPack::entityTable::entityRef pxPack::entityTable::at(const size_t index) {
+            if (index >= size()) {
+                throw std::out_of_range("ERROR: Attempt to access entity " + std::to_string(index) +
+                                        " of a table holding " + std::to_string(size()) + " entities.");
+            }
+            
+            return (*this)[index];
+        }
+        
+        pxPack::entityTable::constEntityRef pxPack::entityTable::at(const size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("ERROR: Attempt to access entity " + std::to_string(index) +
+                                        " of a table holding " + std::to_string(size()) + " entities.");
+            }
+            
+            return (*this)[index];
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> pxPack::entityTable::getFlags() const {
+            return fdl::containerUtil::arrayView <const uint8_t>(flags.data(), flags.size());
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> pxPack::entityTable::getTypes() const {
+            return fdl::containerUtil::arrayView <const uint8_t>(types.data(), types.size());
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> pxPack::entityTable::getUnknownBytes() const {
+            return fdl::containerUtil::arrayView <const uint8_t>(unknownBytes.data(), unknownBytes.size());
+        }
+        
+        fdl::containerUtil::arrayView <const uint16_t> pxPack::entityTable::getXs() const {
+            return fdl::containerUtil::arrayView <const uint16_t>(xs.data(), xs.size());
+        }
+        
+        fdl::containerUtil::arrayView <const uint16_t> pxPack::entityTable::getYs() const {
+            return fdl::containerUtil::arrayView <const uint16_t>(ys.data(), ys.size());
+        }
+        
+        fdl::containerUtil::arrayView <const std::array <uint8_t, pxPack::NUM_UNKNOWN_ENTITY_BYTES>> pxPack::entityTable::getData() const {
+            return fdl::containerUtil::arrayView <const std::array <uint8_t, NUM_UNKNOWN_ENTITY_BYTES>>(data.data(), data.size());
+        }
+        
+        void pxPack::entityTable::setName(const size_t index, const std::string& name) {
+            if (name.size() > entity::NAME_MAX_LEN) {
+                throw std::length_error("ERROR: Attempt to resize entity name to be longer than " +
+                                        std::to_string(entity::NAME_MAX_LEN) + " characters.");
+            }
+            
+            memcpy(names[index].data(), name.data(), name.size());
+            nameLengths[index] = name.size();
+        }
+        
+        void pxPack::entityTable::setPosition(const size_t index, const uint16_t x, const uint16_t y) {
+            const uint16_t OLD_X = xs[index];
+            const uint16_t OLD_Y = ys[index];
+            
+            xs[index] = x;
+            ys[index] = y;
+            
+            if (grid) {
+                grid -> move(index, OLD_X, OLD_Y);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include <string>
+#include <vector>
+#include <array>
+
+#include <thread>
+#include <atomic>
+
+#include <algorithm>
+#include <utility>
+
+#include <stdexcept>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cstring> //memcpy(void* dest, const void* src, size_t count)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/mapRenderer.hpp"
+
+#include "fdl/containerUtil/containerUtil.hpp"
+#include "fdl/containerUtil/byteKernels.hpp"
+#include "fdl/containerUtil/tileGrid.hpp"
+
+#include "fdl/imageUtil/image.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        namespace {
+            typedef fdl::containerUtil::tileGridTraits <pxPack::tileLayer> layerTraits;
+            
+            //a layer to draw, in the order it's drawn
+            struct layerSource {
+                const uint8_t* tiles;
+                size_t width;
+                size_t height;
+                const tilesetAtlas* atlas;
+            };
+            
+            /**
+             * @return The layers to draw from back to front, throwing
+             *         if their atlases' tile sizes differ.
+             */
+            std::vector <layerSource> getLayerSources(const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& layers,
+                                                      const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                                      const renderOptions& options) {
+                std::vector <layerSource> sources;
+                
+                for (int i = pxPack::NUM_LAYERS - 1; i >= 0; --i) {
+                    if (!options.drawLayers.at(i) || nullptr == atlases.at(i)) {
+                        continue;
+                    }
+                    
+                    if (!sources.empty() && sources.front().atlas -> getTileSize() != atlases.at(i) -> getTileSize()) {
+                        throw std::invalid_argument("ERROR: Attempt to render tile layers with atlases of " +
+                                                    std::to_string(sources.front().atlas -> getTileSize()) + " and " +
+                                                    std::to_string(atlases.at(i) -> getTileSize()) + " pixel tiles.");
+                    }
+                    
+                    sources.push_back({layerTraits::getTiles(layers.at(i)), layerTraits::getWidth(layers.at(i)),
+                                       layerTraits::getHeight(layers.at(i)), atlases.at(i)});
+                }
+                
+                return sources;
+            }
+            
+            void renderBand(fdl::imageUtil::rgbaImage& image, const std::vector <layerSource>& sources, const uint32_t tileSize,
+                            const size_t firstRow, const size_t endRow) {
+                const size_t TILE_BYTES = (size_t)tileSize * 4;
+                
+                for (const layerSource& SOURCE : sources) {
+                    const tilesetAtlas& ATLAS = *SOURCE.atlas;
+                    
+                    for (size_t y = firstRow; y < std::min(endRow, SOURCE.height); ++y) {
+                        const uint8_t* const TILES = SOURCE.tiles + fdl::containerUtil::indexFromCoords(0, y, SOURCE.width);
+                        
+                        //pixel row by pixel row, so each row of the image is written from left to right
+                        for (uint32_t row = 0; row < tileSize; ++row) {
+                            uint8_t* out = image.getRow(y * tileSize + row);
+                            
+                            for (size_t x = 0; x < SOURCE.width; ++x, out += TILE_BYTES) {
+                                switch (ATLAS.getCoverage(TILES[x])) {
+                                    case tilesetAtlas::TILE_OPAQUE:
+                                        memcpy(out, ATLAS.getTileRow(TILES[x], row), TILE_BYTES);
+                                        break;
+                                    
+                                    case tilesetAtlas::TILE_MASKED:
+                                        fdl::containerUtil::blitPixels(out, ATLAS.getTileRow(TILES[x], row), tileSize);
+                                        break;
+                                    
+                                    default:
+                                        break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        //definition in hpp, declaration here
+        
+        constexpr uint32_t tilesetAtlas::DEFAULT_TILE_SIZE;
+        
+        
+        tilesetAtlas::tilesetAtlas() : image(), tileSize(DEFAULT_TILE_SIZE), columns(0), coverage(), averageColours() {
+            coverage.fill(TILE_EMPTY);
+        }
+        
+        tilesetAtlas::tilesetAtlas(fdl::imageUtil::rgbaImage image, const uint32_t tileSize) : image(std::move(image)),
+                                                                                            tileSize(tileSize), columns(0),
+                                                                                            coverage(), averageColours() {
+            if (0 == tileSize || 0 != this -> image.width % tileSize || 0 != this -> image.height % tileSize) {
+                throw std::invalid_argument("ERROR: Attempt to cut a " + std::to_string(this -> image.width) + 'x' +
+                                            std::to_string(this -> image.height) + " tileset into " + std::to_string(tileSize) +
+                                            " pixel tiles.");
+            }
+            
+            coverage.fill(TILE_EMPTY);
+            columns = this -> image.width / tileSize;
+            
+            const size_t NUM_TILES = std::min((size_t)columns * (this -> image.height / tileSize), coverage.size());
+            
+            for (size_t i = 0; i < NUM_TILES; ++i) {
+                uint64_t sums [4] = {0, 0, 0, 0};
+                size_t visible = 0;
+                
+                for (uint32_t row = 0; row < tileSize; ++row) {
+                    const uint8_t* pixel = getTileRow(i, row);
+                    
+                    for (uint32_t j = 0; j < tileSize; ++j, pixel += 4) {
+                        if (0 != pixel[3]) {
+                            sums[0] += pixel[0];
+                            sums[1] += pixel[1];
+                            sums[2] += pixel[2];
+                            sums[3] += pixel[3];
+                            ++visible;
+                        }
+                    }
+                }
+                
+                if (0 == visible) {
+                    continue;
+                }
+                
+                coverage[i] = (((size_t)tileSize * tileSize == visible) ? TILE_OPAQUE : TILE_MASKED);
+                
+                for (int j = 0; j < 4; ++j) {
+                    averageColours[i][j] = sums[j] / visible;
+                }
+            }
+        }
+        
+        const fdl::imageUtil::rgbaImage& tilesetAtlas::getImage() const {
+            return image;
+        }
+        
+        uint32_t tilesetAtlas::getTileSize() const {
+            return tileSize;
+        }
+        
+        uint32_t tilesetAtlas::getColumns() const {
+            return columns;
+        }
+        
+        tilesetAtlas::tileCoverage tilesetAtlas::getCoverage(const uint8_t tile) const {
+            return coverage[tile];
+        }
+        
+        const std::array <uint8_t, 4>& tilesetAtlas::getAverageColour(const uint8_t tile) const {
+            return averageColours[tile];
+        }
+        
+        const uint8_t* tilesetAtlas::getTileRow(const uint8_t tile, const uint32_t row) const {
+            return image.getRow((tile / columns) * tileSize + row) + (size_t)(tile % columns) * tileSize * 4;
+        }
+        
+        fdl::imageUtil::rgbaImage renderTileLayers(const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& layers,
+                                                   const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                                   const renderOptions& options) {
+            const std::vector <layerSource> SOURCES = getLayerSources(layers, atlases, options);
+            
+            if (SOURCES.empty()) {
+                return fdl::imageUtil::rgbaImage();
+            }
+            
+            const uint32_t TILE_SIZE = SOURCES.front().atlas -> getTileSize();
+            size_t width = 0, height = 0;
+            
+            for (const layerSource& SOURCE : SOURCES) {
+                width = std::max(width, SOURCE.width);
+                height = std::max(height, SOURCE.height);
+            }
+            
+            fdl::imageUtil::rgbaImage image(width * TILE_SIZE, height * TILE_SIZE, options.background);
+            
+            //bands cover whole rows of tiles, so no two threads ever write to the same pixels
+            const size_t BAND_HEIGHT = std::max(options.bandHeight, (uint32_t)1);
+            const size_t NUM_BANDS = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+            
+            unsigned int maxThreads = ((0 == options.maxThreads) ? std::thread::hardware_concurrency() : options.maxThreads);
+            const size_t NUM_THREADS = std::max(std::min((size_t)maxThreads, NUM_BANDS), (size_t)1);
+            
+            std::atomic <size_t> next(0);
+            
+            const auto WORK = [&]() {
+                for (size_t i = next++; i < NUM_BANDS; i = next++) {
+                    renderBand(image, SOURCES, TILE_SIZE, i * BAND_HEIGHT, std::min((i + 1) * BAND_HEIGHT, height));
+                }
+            };
+            
+            std::vector <std::thread> workers;
+            workers.reserve(NUM_THREADS);
+            
+            for (size_t i = 1; i < NUM_THREADS; ++i) {
+                workers.emplace_back(WORK);
+            }
+            
+            WORK(); //the calling thread works too rather than just waiting
+            
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            
+            return image;
+        }
+        
+        fdl::imageUtil::rgbaImage renderMap(pxPack& map, const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                            const renderOptions& options) {
+            return renderTileLayers(map.getTileLayers(), atlases, options);
+        }
+        
+        fdl::imageUtil::rgbaImage renderMinimap(const std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& layers,
+                                                const std::array <const tilesetAtlas*, pxPack::NUM_LAYERS>& atlases,
+                                                const renderOptions& options) {
+            const std::vector <layerSource> SOURCES = getLayerSources(layers, atlases, options);
+            size_t width = 0, height = 0;
+            
+            for (const layerSource& SOURCE : SOURCES) {
+                width = std::max(width, SOURCE.width);
+                height = std::max(height, SOURCE.height);
+            }
+            
+            fdl::imageUtil::rgbaImage image(width, height, options.background);
+            
+            for (const layerSource& SOURCE : SOURCES) {
+                for (size_t y = 0; y < SOURCE.height; ++y) {
+                    const uint8_t* const TILES = SOURCE.tiles + fdl::containerUtil::indexFromCoords(0, y, SOURCE.width);
+                    uint8_t* out = image.getRow(y);
+                    
+                    for (size_t x = 0; x < SOURCE.width; ++x, out += 4) {
+                        if (tilesetAtlas::TILE_EMPTY != SOURCE.atlas -> getCoverage(TILES[x])) {
+                            memcpy(out, SOURCE.atlas -> getAverageColour(TILES[x]).data(), 4);
+                        }
+                    }
+                }
+            }
+            
+            return image;
+        }
+    }
+}
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <tuple>
+#include <memory>
 
 #include <fstream>
 
@@ -19,12 +21,58 @@
 #include "fdl/keroBlaster/pxPack.hpp"
 
 #include "fdl/fileUtil/fileUtil.hpp"
+#include "fdl/fileUtil/mappedFile.hpp"
+#include "fdl/fileUtil/binaryReader.hpp"
+#include "fdl/fileUtil/binarySchema.hpp"
 
 #include "fdl/containerUtil/containerUtil.hpp"
-#include "fdl/containerUtil/limitedAllocator.hpp"
+#include "fdl/containerUtil/arena.hpp"
+#include "fdl/containerUtil/arenaAllocator.hpp"
+#include "fdl/containerUtil/stringPool.hpp"
 
 namespace fdl {
     namespace keroBlaster {
+        namespace schema = fdl::fileUtil::schema;
+        
+        struct pxPack::fileLayout {
+            //checked on its own first, so a file that isn't a PXPACK file is rejected before any of its head is read
+            typedef schema::record <schema::magic <HEADER, sizeof(HEADER)>> header;
+            
+            //description, script name, map names, spritesheet name and unknown bytes, then tileset names each followed by unknown bytes
+            typedef schema::record <schema::lengthPrefixedString,
+                                    schema::lengthPrefixedString, schema::repeat <NUM_REFERENCED_MAPS, schema::lengthPrefixedString>,
+                                    schema::lengthPrefixedString, schema::byteArray <NUM_UNKNOWN_HEAD_BYTES>,
+                                    schema::repeat <NUM_REFERENCED_TILESETS,
+                                                    schema::record <schema::lengthPrefixedString,
+                                                                    schema::byteArray <NUM_UNKNOWN_TILESET_BYTES>>>> head;
+            
+            typedef std::array <std::tuple <std::string, std::array <uint8_t, NUM_UNKNOWN_TILESET_BYTES>>, NUM_REFERENCED_TILESETS> tilesetValues;
+            
+            //layer header, width and height; whether the flag and tiles follow depends on the dimensions, so they're handled by hand
+            typedef schema::record <schema::magic <LAYER_HEADER, sizeof(LAYER_HEADER)>, schema::uint16LE, schema::uint16LE> layerHead;
+            
+            typedef schema::record <schema::uint16LE> entityCount;
+            
+            //flag, type and unknown byte, x and y, data, and name
+            typedef schema::record <schema::uint8, schema::uint8, schema::uint8, schema::uint16LE, schema::uint16LE,
+                                    schema::byteArray <NUM_UNKNOWN_ENTITY_BYTES>, schema::boundedString <entity::NAME_MAX_LEN>> entityRecord;
+            
+            /**
+             * @return The values written for the head of the given map.
+             */
+            static std::tuple <std::string, std::string, std::array <std::string, NUM_REFERENCED_MAPS>, std::string,
+                               std::array <uint8_t, NUM_UNKNOWN_HEAD_BYTES>, tilesetValues> getHead(const pxPack& map) {
+                tilesetValues tilesets;
+                
+                for (int i = 0; i < NUM_REFERENCED_TILESETS; ++i) {
+                    tilesets.at(i) = std::make_tuple(map.getTilesetName(i), map.unknownTilesetBytes.at(i));
+                }
+                
+                return std::make_tuple(map.description, map.getScriptName(), map.getMapNames(),
+                                       map.getSpritesheetName(), map.unknownHeadBytes, tilesets);
+            }
+        };
+        
         //definition in hpp, declaration here
         
         constexpr char pxPack::FOLDER_NAME [];
@@ -35,6 +83,9 @@ namespace fdl {
         constexpr int pxPack::NUM_REFERENCED_MAPS;
         constexpr int pxPack::NUM_REFERENCED_TILESETS;
         
+        constexpr int pxPack::NUM_UNKNOWN_HEAD_BYTES;
+        constexpr int pxPack::NUM_UNKNOWN_TILESET_BYTES;
+        
         constexpr int pxPack::DESCRIPTION_MAX_LEN;
         
         constexpr int pxPack::NUM_LAYERS;
@@ -48,59 +99,372 @@ namespace fdl {
         pxPack::pxPack() : filename("\0"), originalFilename("\0"), description("\0"),
                            scriptName("\0"), mapNames({("\0"), ("\0"), ("\0")}),
                            spritesheetName("\0"), tilesetNames({("\0"), ("\0"), ("\0")}),
-                           entities(entityVectorAllocator(MAX_NUM_ENTITIES)) {}
+                           namePool(nullptr), scriptNameHandle(fdl::containerUtil::stringPool::EMPTY), mapNameHandles(),
+                           spritesheetNameHandle(fdl::containerUtil::stringPool::EMPTY), tilesetNameHandles(),
+                           unknownHeadBytes(), unknownTilesetBytes(),
+                           entities(entityVectorAllocator(nullptr, MAX_NUM_ENTITIES)) {}
         
-        pxPack::pxPack(const std::string& filename) : description("\0"), scriptName("\0"),
+        pxPack::pxPack(const std::string& filename, const loadMode mode) : description("\0"), scriptName("\0"),
                                                       mapNames({("\0"), ("\0"), ("\0")}),
                                                       spritesheetName("\0"),
                                                       tilesetNames({("\0"), ("\0"), ("\0")}),
-                                                      entities(entityVectorAllocator(MAX_NUM_ENTITIES)) {
-            loadMap(filename);
+                                                      namePool(nullptr),
+                                                      scriptNameHandle(fdl::containerUtil::stringPool::EMPTY),
+                                                      mapNameHandles(),
+                                                      spritesheetNameHandle(fdl::containerUtil::stringPool::EMPTY),
+                                                      tilesetNameHandles(),
+                                                      unknownHeadBytes(), unknownTilesetBytes(),
+                                                      entities(entityVectorAllocator(nullptr, MAX_NUM_ENTITIES)) {
+            loadMap(filename, mode);
+        }
+        
+        void pxPack::loadMap(const std::string& filename, const loadMode mode) {
+            const fdl::errorUtil::result RESULT = tryLoadMap(filename, mode);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, fdl::fileUtil::stripToBaseFilename(filename, FILE_EXTENSION));
+            }
+        }
+        
+        void pxPack::loadFromMemory(const uint8_t* data, const size_t size) {
+            const fdl::errorUtil::result RESULT = tryLoadFromMemory(data, size);
+            
+            if (!RESULT) {
+                throwLoadError(RESULT, "");
+            }
+        }
+        
+        void pxPack::loadFromMemory(const std::vector <uint8_t>& data) {
+            loadFromMemory(data.data(), data.size());
+        }
+        
+        fdl::errorUtil::result pxPack::tryLoadMap(const std::string& filename, const loadMode mode) {
+            const std::string PATH = preparePath(filename);
+            
+            if (LOAD_STREAM == mode) {
+                //read the whole file with one call and parse it from memory rather than stream call by stream call
+                std::vector <uint8_t> buffer;
+                const fdl::errorUtil::result READ_RESULT = fdl::fileUtil::readFile(PATH, buffer);
+                
+                if (!READ_RESULT) {
+                    reset();
+                    return READ_RESULT;
+                }
+                
+                fdl::fileUtil::binaryReader reader(buffer);
+                return parse(reader, nullptr);
+            }
+            
+            const std::shared_ptr <const fdl::fileUtil::mappedFile> MAPPING = fdl::fileUtil::mappedFile::tryMap(PATH);
+            
+            if (nullptr == MAPPING) {
+                reset();
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_OPENFAIL, 0);
+            }
+            
+            fdl::fileUtil::binaryReader reader(*MAPPING);
+            
+            if (LOAD_LAZY == mode) {
+                fdl::errorUtil::result result = readHead(reader);
+                
+                if (result) {
+                    tileLayersOffset = reader.tell();
+                    result = skipTileLayers(reader);
+                    entitiesOffset = reader.tell();
+                }
+                
+                if (result) {
+                    result = internNames(reader.tell());
+                }
+                
+                if (!result) {
+                    reset();
+                    return result;
+                }
+                
+                useArena(0); //nothing is parsed yet, so the arena is only set up once there's something to put in it
+                
+                lazySource = MAPPING;
+                tileLayersPending = true;
+                entitiesPending = true;
+                
+                return result;
+            }
+            
+            return parse(reader, (LOAD_MAPPED_ZERO_COPY == mode) ? MAPPING : nullptr);
+        }
+        
+        fdl::errorUtil::result pxPack::tryLoadFromMemory(const uint8_t* data, const size_t size) {
+            filename = "";
+            originalFilename = "";
+            
+            fdl::fileUtil::binaryReader reader(data, size);
+            return parse(reader, nullptr);
+        }
+        
+        fdl::errorUtil::result pxPack::tryLoadFromMemory(const std::vector <uint8_t>& data) {
+            return tryLoadFromMemory(data.data(), data.size());
+        }
+        
+        std::string pxPack::getLoadErrorMessage(const fdl::errorUtil::result& result, const std::string& filename) {
+            const std::string INDEX = std::to_string(result.getIndex() + 1);
+            
+            switch (result.getCode()) {
+                case fdl::errorUtil::FILE_OPENFAIL:
+                    return "ERROR: Failed to open PXPACK file " + filename + " for parsing.";
+                    
+                case fdl::errorUtil::FILE_READFAIL:
+                    return "ERROR: Could not read PXPACK file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADHEADER:
+                    return "ERROR: Incorrect PXPACK header in file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADHEAD:
+                    return "ERROR: Could not parse head of PXPACK file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADLAYERHEADER:
+                    return "ERROR: Incorrect PXPACK layer header for layer " + INDEX + " of file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADLAYER:
+                    return "ERROR: Could not parse tile layer " + INDEX + " of PXPACK file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADENTITYCOUNT:
+                    return "ERROR: Could not parse entity number of PXPACK file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADENTITY:
+                    return "ERROR: Could not parse entity " + INDEX + " of PXPACK file " + filename + '.';
+                    
+                case fdl::errorUtil::FILE_BADENTITYNAME:
+                    return "ERROR: Name of entity " + INDEX + " in PXPACK file " + filename + " is longer than " +
+                           std::to_string(entity::NAME_MAX_LEN) + " characters.";
+                    
+                default:
+                    return result.getMessage() + filename + '.';
+            }
+        }
+        
+        bool pxPack::isFullyLoaded() const {
+            return (!tileLayersPending && !entitiesPending);
+        }
+        
+        void pxPack::finishLoading() {
+            loadPendingTileLayers();
+            loadPendingEntities();
+        }
+        
+        std::array <pxPack::tileLayer, pxPack::NUM_LAYERS>& pxPack::getTileLayers() {
+            loadPendingTileLayers();
+            return tileLayers;
         }
         
-        void pxPack::loadMap(const std::string& filename) {
-            std::fstream file = open(filename);
+        pxPack::entityVector& pxPack::getEntities() {
+            loadPendingEntities();
+            return entities;
+        }
+        
+        fdl::errorUtil::result pxPack::parse(fdl::fileUtil::binaryReader& file, const std::shared_ptr <const fdl::fileUtil::mappedFile>& mapping) {
+            //anything left over from an earlier lazy load is replaced by this one
+            lazySource.reset();
+            tileLayersPending = false;
+            entitiesPending = false;
+            
+            fdl::errorUtil::result result = readHead(file);
+            
+            if (result) { //only set up the arena once the file looks like a PXPACK file, so rejecting one costs nothing
+                useArena(mapping ? 0 : file.getSize()); //zero-copy layers don't need room for their tiles
+                result = readTileLayers(file, mapping);
+            }
+            
+            if (result) {
+                result = readEntities(file);
+            }
             
-            try {
-                readHead(file);
-                readTileLayers(file);
-                readEntities(file);
+            if (result) { //names are only interned once the whole file has been read, so a bad file leaves nothing in the pool
+                result = internNames(file.tell());
             }
+            
             /* 
              * If any problems occur with parsing the file, completely reset
-             * all properties to avoid data corruption and rethrow the error
+             * all properties to avoid data corruption and return the error
              * so the caller knows parsing failed.
              */
-            catch (const fdl::errorUtil::fileReadError&) {
+            if (!result) {
                 reset();
-                throw;
             }
+            
+            return result;
+        }
+        
+        void pxPack::useArena(const size_t initialSize) {
+            const std::shared_ptr <fdl::containerUtil::arena> ARENA = makeArena(initialSize);
+            
+            useTileArena(ARENA);
+            useEntityArena(ARENA);
+        }
+        
+        void pxPack::useTileArena(const std::shared_ptr <fdl::containerUtil::arena>& source) {
+            //move-assigning hands the new allocator to each container and frees the old arena once nothing uses it
+            for (tileLayer& layer : tileLayers) {
+                layer = tileLayer(source);
+            }
+        }
+        
+        void pxPack::useEntityArena(const std::shared_ptr <fdl::containerUtil::arena>& source) {
+            entities = entityVector(entityVectorAllocator(source, MAX_NUM_ENTITIES));
+        }
+        
+        std::shared_ptr <fdl::containerUtil::arena> pxPack::makeArena(const size_t initialSize) {
+            return ((initialSize > 0) ? std::make_shared <fdl::containerUtil::arena>(initialSize) : nullptr);
+        }
+        
+        void pxPack::save() {
+            finishLoading();
+            
+            if ("" == fdl::keroBlaster::basePath || "" == fdl::keroBlaster::resourceFolder) { //these need to be set first
+                throw std::logic_error("ERROR: Attempt to save PXPACK file without first setting \
+fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder.");
+            }
+            
+            if ("" == filename) {
+                throw std::logic_error("ERROR: Attempt to save PXPACK file without a filename.");
+            }
+            
+            const std::string FOLDER = getFolderPath();
+            const std::string PATH = FOLDER + filename + FILE_EXTENSION;
+            
+            const std::vector <uint8_t> BUFFER = saveToBuffer();
+            
+            if (!fdl::fileUtil::writeFileAtomically(PATH, BUFFER.data(), BUFFER.size())) {
+                throw fdl::errorUtil::fileWriteError("ERROR: Failed to write PXPACK file " + filename + '.');
+            }
+            
+            if ("" != originalFilename && originalFilename != filename) { //the map was renamed, so get rid of the file with the old name
+                const std::string ORIGINAL_PATH = FOLDER + originalFilename + FILE_EXTENSION;
+                remove(ORIGINAL_PATH.c_str());
+            }
+            
+            originalFilename = filename;
+        }
+        
+        size_t pxPack::getFileSize() const {
+            checkFullyLoaded("getFileSize()");
+            
+            size_t size = fileLayout::header::SIZE + fileLayout::head::size(fileLayout::getHead(*this));
+            
+            for (const tileLayer& layer : tileLayers) {
+                size += fileLayout::layerHead::SIZE;
+                
+                const size_t NUM_TILES = (size_t)layer.width * layer.height;
+                
+                if (NUM_TILES > 0) {
+                    size += 1 + NUM_TILES; //flag and tiles
+                }
+            }
+            
+            size += fileLayout::entityCount::SIZE;
+            
+            for (const entity& ent : entities) {
+                size += fileLayout::entityRecord::size(std::tie(ent.flag, ent.type, ent.unknownByte, ent.x, ent.y, ent.data, ent.name));
+            }
+            
+            return size;
+        }
+        
+        void pxPack::saveToBuffer(uint8_t* buffer) const {
+            checkFullyLoaded("saveToBuffer()");
+            
+            buffer = fileLayout::header::encode(buffer, std::make_tuple(true));
+            buffer = fileLayout::head::encode(buffer, fileLayout::getHead(*this));
+            
+            for (const tileLayer& layer : tileLayers) {
+                buffer = fileLayout::layerHead::encode(buffer, std::make_tuple(true, layer.width, layer.height));
+                
+                const size_t NUM_TILES = (size_t)layer.width * layer.height;
+                
+                if (NUM_TILES > 0) {
+                    *buffer++ = layer.flag;
+                    memcpy(buffer, layer.getTileView().data(), NUM_TILES);
+                    buffer += NUM_TILES;
+                }
+            }
+            
+            buffer = fileLayout::entityCount::encode(buffer, std::make_tuple(static_cast <uint16_t>(entities.size())));
+            
+            for (const entity& ent : entities) {
+                buffer = fileLayout::entityRecord::encode(buffer, std::tie(ent.flag, ent.type, ent.unknownByte, ent.x, ent.y, ent.data, ent.name));
+            }
+        }
+        
+        std::vector <uint8_t> pxPack::saveToBuffer() const {
+            std::vector <uint8_t> buffer(getFileSize());
+            saveToBuffer(buffer.data());
+            return buffer;
         }
         
-        std::string pxPack::getFilename() const {
+        const std::string& pxPack::getFilename() const {
             return filename;
         }
         
-        std::string pxPack::getDescription() const {
+        const std::string& pxPack::getDescription() const {
             return description;
         }
         
-        std::string pxPack::getScriptName() const {
+        const std::string& pxPack::getScriptName() const {
             return scriptName;
         }
         
-        std::array <std::string, pxPack::NUM_REFERENCED_MAPS> pxPack::getMapNames() const {
+        const std::array <std::string, pxPack::NUM_REFERENCED_MAPS>& pxPack::getMapNames() const {
             return mapNames;
         }
         
-        std::string pxPack::getSpritesheetName() const {
+        const std::string& pxPack::getMapName(const size_t index) const {
+            return mapNames.at(index);
+        }
+        
+        const std::string& pxPack::getSpritesheetName() const {
             return spritesheetName;
         }
         
-        std::array <std::string, pxPack::NUM_REFERENCED_TILESETS> pxPack::getTilesetNames() const {
+        const std::array <std::string, pxPack::NUM_REFERENCED_TILESETS>& pxPack::getTilesetNames() const {
             return tilesetNames;
         }
         
+        const std::string& pxPack::getTilesetName(const size_t index) const {
+            return tilesetNames.at(index);
+        }
+        
+        fdl::containerUtil::stringPool::handle pxPack::getScriptNameHandle() const {
+            checkStringPool("getScriptNameHandle()");
+            return scriptNameHandle;
+        }
+        
+        const std::array <fdl::containerUtil::stringPool::handle, pxPack::NUM_REFERENCED_MAPS>& pxPack::getMapNameHandles() const {
+            checkStringPool("getMapNameHandles()");
+            return mapNameHandles;
+        }
+        
+        fdl::containerUtil::stringPool::handle pxPack::getSpritesheetNameHandle() const {
+            checkStringPool("getSpritesheetNameHandle()");
+            return spritesheetNameHandle;
+        }
+        
+        const std::array <fdl::containerUtil::stringPool::handle, pxPack::NUM_REFERENCED_TILESETS>& pxPack::getTilesetNameHandles() const {
+            checkStringPool("getTilesetNameHandles()");
+            return tilesetNameHandles;
+        }
+        
+        const std::shared_ptr <fdl::containerUtil::stringPool>& pxPack::getStringPool() const {
+            return namePool;
+        }
+        
+        fdl::containerUtil::arrayView <const pxPack::entity> pxPack::getEntityView() const {
+            if (entitiesPending) {
+                checkFullyLoaded("getEntityView()");
+            }
+            
+            return fdl::containerUtil::arrayView <const entity>(entities.data(), entities.size());
+        }
+        
         void pxPack::reset() {
             filename = "";
             originalFilename = "";
@@ -111,8 +475,26 @@ namespace fdl {
             spritesheetName = "";
             tilesetNames = {"", "", ""};
             
-            tileLayers.fill(tileLayer());
-            entities.clear();
+            //every pool holds the empty string as EMPTY, so the handles stay valid without touching the pool
+            scriptNameHandle = fdl::containerUtil::stringPool::EMPTY;
+            mapNameHandles.fill(fdl::containerUtil::stringPool::EMPTY);
+            spritesheetNameHandle = fdl::containerUtil::stringPool::EMPTY;
+            tilesetNameHandles.fill(fdl::containerUtil::stringPool::EMPTY);
+            
+            unknownHeadBytes.fill(0);
+            unknownTilesetBytes.fill({});
+            
+            useArena(0);
+            
+            lazySource.reset();
+            tileLayersOffset = 0;
+            entitiesOffset = 0;
+            tileLayersPending = false;
+            entitiesPending = false;
+        }
+        
+        std::string pxPack::getFolderPath() {
+            return fdl::keroBlaster::basePath + '\\' + fdl::keroBlaster::resourceFolder + FOLDER_NAME;
         }
         
         void pxPack::setFilename(std::string filename) {
@@ -151,6 +533,7 @@ namespace fdl {
                                         + " characters.");
             }
             else {
+                scriptNameHandle = internName(scriptName);
                 this -> scriptName = scriptName;
             }
         }
@@ -166,6 +549,7 @@ namespace fdl {
                                         + " characters.");
             }
             else {
+                mapNameHandles.at(index) = internName(mapName);
                 mapNames.at(index) = mapName;
             }
         }
@@ -180,6 +564,7 @@ namespace fdl {
                                         + " characters.");
             }
             else {
+                spritesheetNameHandle = internName(spritesheetName);
                 this -> spritesheetName = spritesheetName;
             }
         }
@@ -195,11 +580,23 @@ namespace fdl {
                                         + " characters.");
             }
             else {
+                tilesetNameHandles.at(index) = internName(tilesetName);
                 tilesetNames.at(index) = tilesetName;
             }
         }
         
-        std::fstream pxPack::open(std::string filename) {
+        void pxPack::setStringPool(std::shared_ptr <fdl::containerUtil::stringPool> pool) {
+            namePool.swap(pool);
+            
+            if (!internNames(0)) {
+                namePool.swap(pool); //the handles are only replaced on success, so they still refer to the old pool
+                
+                throw std::length_error("ERROR: Attempt to intern the asset names of PXPACK file " + filename +
+                                        " in a full string pool.");
+            }
+        }
+        
+        std::string pxPack::preparePath(std::string filename) {
             if ("" == fdl::keroBlaster::basePath || "" == fdl::keroBlaster::resourceFolder) { //these need to be set first
                 throw std::logic_error("ERROR: Attempt to open PXPACK file without first setting \
 fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder.");
@@ -209,193 +606,259 @@ fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder.");
             originalFilename = this -> filename; //store the original filename to allow renaming the PXPACK file later
             filename = this -> filename; //ensures filename is cut down to base filename without preceding path or trailing extension
             
-            const std::string PATH = fdl::keroBlaster::basePath + '\\' +
-                                     fdl::keroBlaster::resourceFolder +
-                                     FOLDER_NAME + filename + FILE_EXTENSION;
-            
-            std::fstream file;
+            const std::string PATH = getFolderPath() + filename + FILE_EXTENSION;
             
             if (!fdl::fileUtil::fileExists(PATH)) {
                 //Create dummy PXPACK file if the given one doesn't exist
                 
-                //TODO: After implementing pxPack::save(), just call that here and erase everything else in this if statement
-                
-                file.open(PATH, std::fstream::out | std::fstream::binary);
+                const std::vector <uint8_t> DUMMY = pxPack().saveToBuffer();
                 
-                if (!file) {
-                    throw fdl::errorUtil::fileOpenError("ERROR: Failed to open PXPACK file " + filename + " for dummy writing.");
+                if (!fdl::fileUtil::writeFileAtomically(PATH, DUMMY.data(), DUMMY.size())) {
+                    throw fdl::errorUtil::fileWriteError("ERROR: Failed to write dummy values to PXPACK file " + filename + '.');
                 }
+            }
+            
+            return PATH;
+        }
+        
+        fdl::errorUtil::result pxPack::readHead(fdl::fileUtil::binaryReader& file) {
+            const size_t START = file.tell();
+            
+            bool headerMatched = false;
+            
+            if (!fileLayout::header::read(file, std::tie(headerMatched)) || !headerMatched) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADHEADER, START);
+            }
+            
+            fileLayout::tilesetValues tilesets;
+            
+            if (!fileLayout::head::read(file, std::tie(description, scriptName, mapNames, spritesheetName,
+                                                       unknownHeadBytes, tilesets))) { //parsing failed somewhere
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADHEAD, file.tell());
+            }
+            
+            for (int i = 0; i < NUM_REFERENCED_TILESETS; ++i) {
+                tilesetNames.at(i) = std::move(std::get <0>(tilesets.at(i)));
+                unknownTilesetBytes.at(i) = std::get <1>(tilesets.at(i));
+            }
+            
+            return fdl::errorUtil::result();
+        }
+        
+        fdl::errorUtil::result pxPack::readTileLayers(fdl::fileUtil::binaryReader& file, const std::shared_ptr <const fdl::fileUtil::mappedFile>& mapping) {
+            for (int i = 0; i < NUM_LAYERS; ++i) {
+                uint16_t width = 0, height = 0;
+                const fdl::errorUtil::result HEAD = readLayerHead(file, i, width, height);
                 
-                file.write(HEADER, strlen(HEADER) + 1); //+ 1 to include null-terminator, which appears in the file
-                
-                file.put(0); //description
-                
-                file.put(0); //script
-                
-                for (int i = 0; i < NUM_REFERENCED_MAPS; ++i) { //mapnames
-                    file.put(0);
+                if (!HEAD) {
+                    return HEAD;
                 }
                 
-                file.put(0); //spritesheet
+                const size_t NUM_TILES = (size_t)width * height;
                 
-                for (int i = 0; i < 8; ++i) { //8 unknown bytes after spritesheet
-                    file.put(0);
+                if (NUM_TILES > 0) {
+                    tileLayers.at(i).setFlag(file.get());
+                    
+                    const uint8_t* const TILES = file.skip(NUM_TILES); //checks the whole block against the file length at once
+                    
+                    if (nullptr != TILES) {
+                        if (nullptr != mapping) { //point the layer straight at its tiles in the mapping
+                            tileLayers.at(i).mapTiles(width, height, TILES, mapping);
+                        }
+                        else {
+                            tileLayers.at(i).setTiles(width, height, TILES);
+                        }
+                    }
+                }
+                else {
+                    tileLayers.at(i).setDimensions(width, height);
                 }
                 
-                for (int i = 0; i < NUM_REFERENCED_TILESETS; ++i) { //tilesets
-                    file.put(0);
-                    
-                    file.write("\0\0", 2); //2 unknown bytes after each tileset
+                if (!file.good()) { //parsing failed somewhere
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, file.tell(), i);
                 }
+            }
+            
+            return fdl::errorUtil::result();
+        }
+        
+        fdl::errorUtil::result pxPack::skipTileLayers(fdl::fileUtil::binaryReader& file) {
+            for (int i = 0; i < NUM_LAYERS; ++i) {
+                uint16_t width = 0, height = 0;
+                const fdl::errorUtil::result HEAD = readLayerHead(file, i, width, height);
                 
-                for (int i = 0; i < NUM_LAYERS; ++i) {
-                    file.write(LAYER_HEADER, strlen(LAYER_HEADER) + 1); //+ 1 to include null terminator, which is in the file
-                    file.write("\0\0", 2); //width
-                    file.write("\0\0", 2); //height
+                if (!HEAD) {
+                    return HEAD;
                 }
                 
-                file.write("\0\0", 2); //number of entities
+                const size_t NUM_TILES = (size_t)width * height;
                 
-                if (!file.good()) {
-                    remove(PATH.c_str());
-                    throw fdl::errorUtil::fileWriteError("ERROR: Failed to write dummy values to PXPACK file " + filename + '.');
+                if (NUM_TILES > 0) {
+                    file.skip(1 + NUM_TILES); //flag and tiles
                 }
                 
-                file.close();
+                if (!file.good()) { //parsing failed somewhere
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, file.tell(), i);
+                }
             }
             
-            file.open(PATH, std::fstream::in | std::fstream::binary);
+            return fdl::errorUtil::result();
+        }
+        
+        fdl::errorUtil::result pxPack::readLayerHead(fdl::fileUtil::binaryReader& file, const int index, uint16_t& width, uint16_t& height) {
+            const size_t START = file.tell();
+            
+            bool headerMatched = false;
+            const bool READ = fileLayout::layerHead::read(file, std::tie(headerMatched, width, height)); //one bounds check for the header and dimensions
             
-            if (!file) {
-                throw fdl::errorUtil::fileOpenError("ERROR: Failed to open PXPACK file " + filename + " for parsing.");
+            if (!READ) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYER, START, index);
             }
             
-            return file;
+            if (!headerMatched) { //always three instances of "pxMAP01", regardless of if all layers have content
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADLAYERHEADER, START, index);
+            }
+            
+            return fdl::errorUtil::result();
         }
         
-        void pxPack::readHead(std::fstream& file) {
-            if (std::string(HEADER) != readHeader(file)) {
-                throw fdl::errorUtil::fileReadError("ERROR: Incorrect PXPACK header in file " + filename + '.');
+        void pxPack::loadPendingTileLayers() {
+            if (!tileLayersPending) {
+                return;
             }
             
-            description = readString(file);
+            //read from the start of the file so error offsets are from there too
+            fdl::fileUtil::binaryReader reader(*lazySource);
+            reader.skip(tileLayersOffset);
             
-            scriptName = readString(file);
+            useTileArena(makeArena(entitiesOffset - tileLayersOffset)); //sized for the tiles about to be read
+            const fdl::errorUtil::result RESULT = readTileLayers(reader, nullptr);
             
-            for (int i = 0; i < NUM_REFERENCED_MAPS; ++i) {
-                mapNames.at(i) = readString(file);
+            if (!RESULT) {
+                const std::string FILENAME = filename; //reset() clears it
+                reset();
+                throwLoadError(RESULT, FILENAME);
             }
             
-            spritesheetName = readString(file);
+            tileLayersPending = false;
             
-            file.ignore(8);
+            if (!entitiesPending) { //nothing else needs the file
+                lazySource.reset();
+            }
+        }
+        
+        void pxPack::loadPendingEntities() {
+            if (!entitiesPending) {
+                return;
+            }
             
-            for (int i = 0; i < NUM_REFERENCED_TILESETS; ++i) {
-                tilesetNames.at(i) = readString(file);
-                file.ignore(2);
+            fdl::fileUtil::binaryReader reader(*lazySource);
+            reader.skip(entitiesOffset);
+            
+            useEntityArena(makeArena(lazySource -> size() - entitiesOffset));
+            const fdl::errorUtil::result RESULT = readEntities(reader);
+            
+            if (!RESULT) {
+                const std::string FILENAME = filename;
+                reset();
+                throwLoadError(RESULT, FILENAME);
             }
             
-            if (!file.good()) { //parsing failed somewhere
-                throw fdl::errorUtil::fileReadError("ERROR: Could not parse head of PXPACK file " + filename + '.');
+            entitiesPending = false;
+            
+            if (!tileLayersPending) { //nothing else needs the file
+                lazySource.reset();
             }
         }
         
-        void pxPack::readTileLayers(std::fstream& file) {
-            for (int i = 0; i < NUM_LAYERS; ++i) {
-                char layerHeader[strlen(LAYER_HEADER) + 1] = {0}; //+ 1 to include null terminator, which is in the file
-                file.read(layerHeader, strlen(LAYER_HEADER) + 1);
-                if (std::string(LAYER_HEADER) != std::string(layerHeader)) { //always three instances of "pxMAP01", regardless of if all layers have content
-                    throw fdl::errorUtil::fileReadError("ERROR: Incorrect PXPACK layer header for layer " +
-                                                        std::to_string(i + 1) + " of file " + filename + '.');
-                }
-                
-                uint16_t width, height;
-                
-                file.read((char*)&width, sizeof(width));
-                file.read((char*)&height, sizeof(height));
-                
-                if (!fdl::fileUtil::isLittleEndian()) { //if we're on a big-endian system, swap bytes to little-endian
-                    width = fdl::fileUtil::byteswapUInt16(width);
-                    height = fdl::fileUtil::byteswapUInt16(height);
-                }
-                
-                tileLayers.at(i).setDimensions(width, height);
-                
-                if (width * height > 0) {
-                    tileLayers.at(i).setFlag(file.get());
+        void pxPack::throwLoadError(const fdl::errorUtil::result& result, const std::string& filename) {
+            const std::string MESSAGE = getLoadErrorMessage(result, filename);
+            
+            switch (result.getCode()) {
+                case fdl::errorUtil::FILE_OPENFAIL:
+                    throw fdl::errorUtil::fileOpenError(MESSAGE);
                     
-                    for (int j = 0; j < height; ++j) {
-                        for (int k = 0; k < width; ++k) {                            
-                            const uint8_t TILE = file.get();
-                            tileLayers.at(i).setTile(k, j, TILE);
-                        }
-                    }
-                }
-                
-                if (!file.good()) { //parsing failed somewhere
-                    throw fdl::errorUtil::fileReadError("ERROR: Could not parse tile layer " + std::to_string(i + 1) + " of PXPACK file " + filename + '.');
-                }
+                case fdl::errorUtil::FILE_BADENTITYNAME:
+                case fdl::errorUtil::FILE_NAMEPOOLFULL:
+                    throw std::length_error(MESSAGE);
+                    
+                default:
+                    throw fdl::errorUtil::fileReadError(MESSAGE);
             }
         }
         
-        void pxPack::readEntities(std::fstream& file) {
-            uint16_t numEntities; //Pretty sure it's 2 bytes
-            file.read((char*)&numEntities, sizeof(numEntities));
-            entities.resize(numEntities);
-            
-            if (!file.good()) { //parsing failed somewhere
-                throw fdl::errorUtil::fileReadError("ERROR: Could not parse entity number of PXPACK file " + filename + '.');
+        void pxPack::checkFullyLoaded(const std::string& method) const {
+            if (!isFullyLoaded()) {
+                throw std::logic_error("ERROR: Attempt to call pxPack::" + method + " on PXPACK file " + filename +
+                                       " before it finished loading.");
+            }
+        }
+        
+        void pxPack::checkStringPool(const std::string& method) const {
+            if (nullptr == namePool) {
+                throw std::logic_error("ERROR: Attempt to call pxPack::" + method + " on PXPACK file " + filename +
+                                       " without first giving it a string pool.");
             }
+        }
+        
+        fdl::errorUtil::result pxPack::internNames(const size_t offset) {
+            fdl::containerUtil::stringPool::handle script = fdl::containerUtil::stringPool::EMPTY;
+            fdl::containerUtil::stringPool::handle spritesheet = fdl::containerUtil::stringPool::EMPTY;
+            std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_MAPS> maps = {};
+            std::array <fdl::containerUtil::stringPool::handle, NUM_REFERENCED_TILESETS> tilesets = {};
             
-            for (int i = 0; i < numEntities; ++i) {
-                entities.at(i).setFlag(file.get());
-                
-                entities.at(i).setType(file.get());
-                
-                entities.at(i).setUnknownByte(file.get());
-                
-                uint16_t x, y;
-                file.read((char*)&x, sizeof(x));
-                file.read((char*)&y, sizeof(y));
+            if (namePool) {
+                bool interned = namePool -> tryIntern(scriptName, script) && namePool -> tryIntern(spritesheetName, spritesheet);
                 
-                if (!fdl::fileUtil::isLittleEndian()) { //if we're on a big-endian system, swap bytes to little-endian
-                    x = fdl::fileUtil::byteswapUInt16(x);
-                    y = fdl::fileUtil::byteswapUInt16(y);
+                for (int i = 0; i < NUM_REFERENCED_MAPS && interned; ++i) {
+                    interned = namePool -> tryIntern(mapNames.at(i), maps.at(i));
                 }
                 
-                entities.at(i).setX(x);
-                entities.at(i).setY(y);
-                
-                uint8_t data[NUM_UNKNOWN_ENTITY_BYTES];
-                file.read((char*)&data, NUM_UNKNOWN_ENTITY_BYTES);
-                for (int j = 0; j < NUM_UNKNOWN_ENTITY_BYTES; ++j) {
-                    entities.at(i).setData(j, data[j]);
+                for (int i = 0; i < NUM_REFERENCED_TILESETS && interned; ++i) {
+                    interned = namePool -> tryIntern(tilesetNames.at(i), tilesets.at(i));
                 }
                 
-                entities.at(i).setName(readString(file));
-                
-                if (!file.good()) { //parsing failed somewhere
-                    throw fdl::errorUtil::fileReadError("ERROR: Could not parse entity " + std::to_string(i + 1) + " of PXPACK file " + filename + '.');
+                if (!interned) {
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_NAMEPOOLFULL, offset);
                 }
             }
+            
+            scriptNameHandle = script;
+            mapNameHandles = maps;
+            spritesheetNameHandle = spritesheet;
+            tilesetNameHandles = tilesets;
+            
+            return fdl::errorUtil::result();
         }
         
-        std::string pxPack::readHeader(std::fstream& file) {            
-            char header [strlen(HEADER) + 1] = {0};  //+ 1 to include null-terminator, which appears in the file
-            file.read(header, strlen(HEADER) + 1);
-            
-            return std::string(header);
+        fdl::containerUtil::stringPool::handle pxPack::internName(const std::string& name) {
+            return (namePool ? namePool -> intern(name) : fdl::containerUtil::stringPool::EMPTY);
         }
         
-        std::string pxPack::readString(std::fstream& file) {
-            const uint8_t LEN = file.get(); //grab string length
-            char* str = new char [LEN + 1] {0};
-            file.read(str, LEN); //grab string
+        fdl::errorUtil::result pxPack::readEntities(fdl::fileUtil::binaryReader& file) {
+            uint16_t numEntities = 0; //Pretty sure it's 2 bytes
+            
+            if (!fileLayout::entityCount::read(file, std::tie(numEntities))) {
+                return fdl::errorUtil::result(fdl::errorUtil::FILE_BADENTITYCOUNT, file.tell());
+            }
             
-            const std::string RTN_STR = str;
-            delete[] str;
+            entities.resize(numEntities);
+            
+            for (int i = 0; i < numEntities; ++i) {
+                entity& ent = entities.at(i);
+                const size_t START = file.tell();
+                
+                //everything before the name is one fixed-size run, checked against the file length at once
+                if (!fileLayout::entityRecord::read(file, std::tie(ent.flag, ent.type, ent.unknownByte, ent.x, ent.y, ent.data, ent.name))) {
+                    if (file.good()) { //the name was too long rather than cut off
+                        return fdl::errorUtil::result(fdl::errorUtil::FILE_BADENTITYNAME, START, i);
+                    }
+                    
+                    return fdl::errorUtil::result(fdl::errorUtil::FILE_BADENTITY, file.tell(), i);
+                }
+            }
             
-            return RTN_STR;
+            return fdl::errorUtil::result();
         }
     }
 }
\ No newline at end of file
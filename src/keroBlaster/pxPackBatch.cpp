@@ -0,0 +1,101 @@
+#include <string>
+#include <vector>
+
+#include <thread>
+#include <atomic>
+
+#include <utility>
+
+#include <exception>
+#include <stdexcept>
+
+#include "fdl/keroBlaster/keroBlaster.hpp"
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/pxPackBatch.hpp"
+
+#include "fdl/errorUtil/errorUtil.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        pxPackBatch loadPxPacks(const std::vector <std::string>& filenames, const pxPack::loadMode mode,
+                                unsigned int maxThreads) {
+            if ("" == fdl::keroBlaster::basePath || "" == fdl::keroBlaster::resourceFolder) { //these need to be set first
+                throw std::logic_error("ERROR: Attempt to open PXPACK files without first setting \
+fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder.");
+            }
+            
+            if (0 == maxThreads) {
+                maxThreads = std::thread::hardware_concurrency();
+            }
+            
+            const size_t NUM_THREADS = ((maxThreads < filenames.size()) ? maxThreads : filenames.size());
+            
+            //each file gets its own slot so workers never write to the same place
+            std::vector <pxPack> maps(filenames.size());
+            std::vector <fdl::errorUtil::result> results(filenames.size());
+            std::vector <std::string> messages(filenames.size());
+            std::vector <char> failed(filenames.size(), false);
+            
+            std::atomic <size_t> next(0);
+            
+            const auto WORK = [&]() {
+                for (size_t i = next++; i < filenames.size(); i = next++) {
+                    try {
+                        results.at(i) = maps.at(i).tryLoadMap(filenames.at(i), mode);
+                        failed.at(i) = !results.at(i);
+                    }
+                    catch (const std::exception& e) { //misuse, such as a filename that's too long
+                        messages.at(i) = e.what();
+                        failed.at(i) = true;
+                    }
+                }
+            };
+            
+            std::vector <std::thread> workers;
+            workers.reserve(NUM_THREADS);
+            
+            for (size_t i = 1; i < NUM_THREADS; ++i) {
+                workers.emplace_back(WORK);
+            }
+            
+            WORK(); //the calling thread works too rather than just waiting
+            
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            
+            pxPackBatch batch;
+            batch.maps.reserve(filenames.size());
+            
+            for (size_t i = 0; i < filenames.size(); ++i) {
+                if (failed.at(i)) {
+                    const fdl::errorUtil::result& RESULT = results.at(i);
+                    
+                    //messages are only built here, for the files that failed, rather than on each worker's error path
+                    if (!RESULT) {
+                        messages.at(i) = pxPack::getLoadErrorMessage(RESULT, fdl::fileUtil::stripToBaseFilename(filenames.at(i),
+                                                                                                             pxPack::FILE_EXTENSION));
+                    }
+                    
+                    batch.errors.push_back({filenames.at(i), messages.at(i), RESULT.getCode(), RESULT.getOffset()});
+                }
+                else {
+                    batch.maps.push_back(std::move(maps.at(i)));
+                }
+            }
+            
+            return batch;
+        }
+        
+        pxPackBatch loadFieldFolder(const pxPack::loadMode mode, unsigned int maxThreads) {
+            if ("" == fdl::keroBlaster::basePath || "" == fdl::keroBlaster::resourceFolder) { //these need to be set first
+                throw std::logic_error("ERROR: Attempt to open PXPACK files without first setting \
+fdl::keroBlaster::basePath and fdl::keroBlaster::resourceFolder.");
+            }
+            
+            return loadPxPacks(fdl::fileUtil::listFiles(pxPack::getFolderPath(), pxPack::FILE_EXTENSION), mode, maxThreads);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <iterator>
+
+#include <mutex>
+#include <future>
+#include <exception>
+
+#include <stdexcept>
+
+#include <cstdint>
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/pxPackCache.hpp"
+
+#include "fdl/fileUtil/fileUtil.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        pxPackCache::pxPackCache(const size_t memoryBudget, const pxPack::loadMode mode) : memoryBudget(memoryBudget),
+                                                                                          memoryUsage(0), mode(mode) {
+            if (pxPack::LOAD_LAZY == mode) {
+                throw std::invalid_argument("ERROR: Attempt to create a PXPACK cache that loads maps lazily.");
+            }
+        }
+        
+        std::shared_ptr <const pxPack> pxPackCache::get(const std::string& filename) {
+            const std::string KEY = fdl::fileUtil::stripToBaseFilename(filename, pxPack::FILE_EXTENSION);
+            const std::string PATH = pxPack::getFolderPath() + KEY + pxPack::FILE_EXTENSION;
+            
+            fdl::fileUtil::fileStatus status;
+            const bool EXISTS = fdl::fileUtil::getFileStatus(PATH, status);
+            
+            std::promise <std::shared_ptr <const pxPack>> promise;
+            
+            {
+                std::unique_lock <std::mutex> lock(mutex);
+                
+                const auto FOUND = index.find(KEY);
+                
+                if (index.end() != FOUND) {
+                    const entry& cached = *(FOUND -> second);
+                    
+                    if (EXISTS && cached.status.size == status.size && cached.status.modifiedTime == status.modifiedTime) {
+                        entries.splice(entries.begin(), entries, FOUND -> second); //mark as most recently used
+                        ++counters.hits;
+                        return cached.map;
+                    }
+                    
+                    remove(FOUND -> second); //the file changed since it was cached
+                    ++counters.invalidations;
+                }
+                
+                const auto LOADING = pending.find(KEY);
+                
+                //share a load of the same version of the file that's already under way
+                if (EXISTS && pending.end() != LOADING && LOADING -> second.status.size == status.size &&
+                    LOADING -> second.status.modifiedTime == status.modifiedTime) {
+                    const std::shared_future <std::shared_ptr <const pxPack>> RESULT = LOADING -> second.result;
+                    ++counters.hits;
+                    
+                    lock.unlock();
+                    return RESULT.get(); //rethrows the loading thread's exception if it failed
+                }
+                
+                ++counters.misses;
+                
+                //a newer load replaces an older one here, but the older one still finishes for whoever waits on it
+                if (EXISTS) {
+                    pending[KEY] = {status, promise.get_future().share(), &promise};
+                }
+            }
+            
+            //load without holding the lock so other maps can still be served in the meantime
+            std::shared_ptr <const pxPack> map;
+            
+            try {
+                map = std::make_shared <const pxPack>(KEY, mode);
+            }
+            catch (...) {
+                promise.set_exception(std::current_exception());
+                
+                std::lock_guard <std::mutex> lock(mutex);
+                finishPending(KEY, &promise);
+                
+                throw;
+            }
+            
+            promise.set_value(map);
+            
+            //if the file changed while it was loaded, keep the older status so the next request reloads it
+            fdl::fileUtil::fileStatus loadedStatus;
+            
+            if (!EXISTS) { //loading created a dummy file
+                fdl::fileUtil::getFileStatus(PATH, status);
+            }
+            else if (!fdl::fileUtil::getFileStatus(PATH, loadedStatus) || loadedStatus.size != status.size ||
+                     loadedStatus.modifiedTime != status.modifiedTime) {
+                status.modifiedTime = -1; //older than any real file, so it also loses to any other thread's copy
+            }
+            
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            finishPending(KEY, &promise);
+            insert(KEY, map, status);
+            return map;
+        }
+        
+        void pxPackCache::insert(const std::string& key, const std::shared_ptr <const pxPack>& map,
+                                 const fdl::fileUtil::fileStatus& status) {
+            const auto FOUND = index.find(key);
+            
+            if (index.end() != FOUND) {
+                //another thread cached this map while it was being loaded; keep whichever comes from the newer file
+                if (FOUND -> second -> status.modifiedTime > status.modifiedTime) {
+                    return;
+                }
+                
+                remove(FOUND -> second);
+            }
+            
+            entries.push_front({key, map, status, estimateMemoryUsage(*map)});
+            index[key] = entries.begin();
+            memoryUsage += entries.front().memoryUsage;
+            
+            evict();
+        }
+        
+        void pxPackCache::finishPending(const std::string& key, const void* owner) {
+            const auto LOADING = pending.find(key);
+            
+            if (pending.end() != LOADING && owner == LOADING -> second.owner) {
+                pending.erase(LOADING);
+            }
+        }
+        
+        void pxPackCache::erase(const std::string& filename) {
+            const std::string KEY = fdl::fileUtil::stripToBaseFilename(filename, pxPack::FILE_EXTENSION);
+            
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            const auto FOUND = index.find(KEY);
+            
+            if (index.end() != FOUND) {
+                remove(FOUND -> second);
+            }
+        }
+        
+        void pxPackCache::clear() {
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            entries.clear();
+            index.clear();
+            memoryUsage = 0;
+        }
+        
+        void pxPackCache::setMemoryBudget(const size_t memoryBudget) {
+            std::lock_guard <std::mutex> lock(mutex);
+            
+            this -> memoryBudget = memoryBudget;
+            evict();
+        }
+        
+        size_t pxPackCache::getMemoryBudget() const {
+            std::lock_guard <std::mutex> lock(mutex);
+            return memoryBudget;
+        }
+        
+        size_t pxPackCache::getMemoryUsage() const {
+            std::lock_guard <std::mutex> lock(mutex);
+            return memoryUsage;
+        }
+        
+        size_t pxPackCache::getSize() const {
+            std::lock_guard <std::mutex> lock(mutex);
+            return entries.size();
+        }
+        
+        pxPackCache::stats pxPackCache::getStats() const {
+            std::lock_guard <std::mutex> lock(mutex);
+            return counters;
+        }
+        
+        void pxPackCache::evict() {
+            while (memoryUsage > memoryBudget && entries.size() > 1) {
+                remove(std::prev(entries.end()));
+                ++counters.evictions;
+            }
+        }
+        
+        void pxPackCache::remove(const std::list <entry>::iterator it) {
+            memoryUsage -= it -> memoryUsage;
+            index.erase(it -> key);
+            entries.erase(it);
+        }
+        
+        size_t pxPackCache::estimateMemoryUsage(const pxPack& map) {
+            //the serialized size covers the strings and tiles; entities take more room in memory than on disk
+            return sizeof(pxPack) + map.getFileSize() + map.entities.size() * sizeof(pxPack::entity);
+        }
+    }
+}
\ No newline at end of file
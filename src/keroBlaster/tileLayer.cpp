@@ -1,14 +1,86 @@
+#include <string>
 #include <vector>
+#include <array>
+#include <memory>
+
+#include <stdexcept>
 
 #include <cstdint>
 
+#include <cstring> //memcpy(void* dest, const void* src, size_t count), memmove(...), memset(...)
+
 #include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/collisionLayer.hpp"
 
 #include "fdl/containerUtil/containerUtil.hpp"
+#include "fdl/containerUtil/arrayView.hpp"
+#include "fdl/containerUtil/arena.hpp"
+#include "fdl/containerUtil/arenaAllocator.hpp"
+#include "fdl/containerUtil/byteKernels.hpp"
+#include "fdl/containerUtil/tileGrid.hpp"
+
+#include "fdl/fileUtil/mappedFile.hpp"
 
 namespace fdl {
     namespace keroBlaster {
-        pxPack::tileLayer::tileLayer() : width(0), height(0), flag(0), tiles(0, 0) {}
+        pxPack::tileLayer::tileLayer() : tileLayer(nullptr) {}
+        
+        pxPack::tileLayer::tileLayer(std::shared_ptr <fdl::containerUtil::arena> source) :
+                                     width(0), height(0), flag(0),
+                                     tiles(tileAllocator(std::move(source), (size_t)UINT16_MAX * UINT16_MAX)),
+                                     mappedTiles(nullptr), collision(nullptr) {}
+        
+        pxPack::tileLayer::tileLayer(const tileLayer& other) : width(other.width), height(other.height), flag(other.flag),
+                                                               tiles(other.tiles), mappedTiles(other.mappedTiles),
+                                                               mapping(other.mapping), collision(nullptr) {}
+        
+        pxPack::tileLayer& pxPack::tileLayer::operator=(const tileLayer& other) {
+            if (this != &other) {
+                width = other.width;
+                height = other.height;
+                flag = other.flag;
+                tiles = other.tiles;
+                mappedTiles = other.mappedTiles;
+                mapping = other.mapping;
+                
+                if (collision) {
+                    collision -> rebuild();
+                }
+            }
+            
+            return *this;
+        }
+        
+        pxPack::tileLayer::tileLayer(tileLayer&& other) : width(other.width), height(other.height), flag(other.flag),
+                                                          tiles(std::move(other.tiles)), mappedTiles(other.mappedTiles),
+                                                          mapping(std::move(other.mapping)), collision(nullptr) {
+            other.reset();
+        }
+        
+        pxPack::tileLayer& pxPack::tileLayer::operator=(tileLayer&& other) {
+            if (this != &other) {
+                width = other.width;
+                height = other.height;
+                flag = other.flag;
+                tiles = std::move(other.tiles);
+                mappedTiles = other.mappedTiles;
+                mapping = std::move(other.mapping);
+                
+                other.reset();
+                
+                if (collision) {
+                    collision -> rebuild();
+                }
+            }
+            
+            return *this;
+        }
+        
+        pxPack::tileLayer::~tileLayer() {
+            if (collision) {
+                collision -> layer = nullptr;
+            }
+        }
         
         uint16_t pxPack::tileLayer::getWidth() const {
             return width;
@@ -23,7 +95,39 @@ namespace fdl {
         }
         
         std::vector <uint8_t> pxPack::tileLayer::getTiles() const {
-            return tiles;
+            if (isMapped()) {
+                return std::vector <uint8_t>(mappedTiles, mappedTiles + ((size_t)width * height));
+            }
+            
+            return std::vector <uint8_t>(tiles.begin(), tiles.end());
+        }
+        
+        uint8_t pxPack::tileLayer::getTile(const uint16_t x, const uint16_t y) const {
+            if (x >= width || y >= height) {
+                throw std::out_of_range("ERROR: Attempt to get tile (" + std::to_string(x) + ", " + std::to_string(y) +
+                                        ") of a " + std::to_string(width) + 'x' + std::to_string(height) + " tile layer.");
+            }
+            
+            return getTileView()[fdl::containerUtil::indexFromCoords(x, y, width)];
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> pxPack::tileLayer::getTileView() const {
+            return fdl::containerUtil::arrayView <const uint8_t>((isMapped() ? mappedTiles : tiles.data()),
+                                                                 (size_t)width * height);
+        }
+        
+        fdl::containerUtil::arrayView <const uint8_t> pxPack::tileLayer::getRowView(const uint16_t y) const {
+            if (y >= height) {
+                throw std::out_of_range("ERROR: Attempt to view row " + std::to_string(y) + " of a tile layer with height " +
+                                        std::to_string(height) + '.');
+            }
+            
+            return fdl::containerUtil::arrayView <const uint8_t>(getTileView().data() +
+                                                                 fdl::containerUtil::indexFromCoords(0, y, width), width);
+        }
+        
+        bool pxPack::tileLayer::isMapped() const {
+            return (nullptr != mappedTiles);
         }
         
         void pxPack::tileLayer::reset() {
@@ -31,6 +135,12 @@ namespace fdl {
             height = 0;
             flag = 0;
             tiles.clear();
+            mappedTiles = nullptr;
+            mapping.reset();
+            
+            if (collision) {
+                collision -> rebuild();
+            }
         }
         
         void pxPack::tileLayer::setDimensions(const uint16_t width, const uint16_t height) {
@@ -43,20 +153,64 @@ namespace fdl {
             this -> width = width; //write new dimensions
             this -> height = height;
             
-            const std::vector <uint8_t> OLD_TILES(tiles); //save old tileset
-            tiles.clear();
-            tiles.resize(width * height); //resize new tileset and (automatically) set all values to 0
+            const size_t NEW_SIZE = (size_t)width * height;
+            const uint16_t COPY_WIDTH = ((width < OLD_WIDTH) ? width : OLD_WIDTH); //copy each row of the smaller dimensions
+            const uint16_t COPY_HEIGHT = ((height < OLD_HEIGHT) ? height : OLD_HEIGHT);
             
-            const uint16_t LOOP_WIDTH = ((width < OLD_WIDTH) ? width : OLD_WIDTH); //loop for each index in the smaller dimension
-            const uint16_t LOOP_HEIGHT = ((height < OLD_HEIGHT) ? height : OLD_HEIGHT);
+            if (isMapped()) { //the tiles have to be copied out of the mapping anyway, so copy them straight to their new rows
+                tiles.resize(NEW_SIZE);
+                memset(tiles.data(), 0, NEW_SIZE);
+                
+                for (int i = 0; i < COPY_HEIGHT; ++i) {
+                    memcpy(tiles.data() + fdl::containerUtil::indexFromCoords(0, i, width),
+                           mappedTiles + fdl::containerUtil::indexFromCoords(0, i, OLD_WIDTH), COPY_WIDTH);
+                }
+                
+                mappedTiles = nullptr;
+                mapping.reset();
+                
+                if (collision) {
+                    collision -> rebuild();
+                }
+                
+                return;
+            }
             
-            for (int i = 0; i < LOOP_HEIGHT; ++i) {
-                for (int j = 0; j < LOOP_WIDTH; ++j) {
-                    const size_t NEW_INDEX = fdl::containerUtil::indexFromCoords(j, i, width);
-                    const size_t OLD_INDEX = fdl::containerUtil::indexFromCoords(j, i, OLD_WIDTH);
-                    tiles.at(NEW_INDEX) = OLD_TILES.at(OLD_INDEX);
+            /*
+             * Rows are moved in place. When they get narrower, each one moves
+             * towards the start, so copying from the first row on never
+             * overwrites a row that hasn't moved yet. When they get wider,
+             * each one moves towards the end, so the buffer grows first and
+             * rows are copied from the last one back. The buffer keeps its
+             * capacity, so it's only reallocated when the layer outgrows it.
+             */
+            if (width <= OLD_WIDTH) {
+                for (int i = 0; i < COPY_HEIGHT; ++i) {
+                    memmove(tiles.data() + fdl::containerUtil::indexFromCoords(0, i, width),
+                            tiles.data() + fdl::containerUtil::indexFromCoords(0, i, OLD_WIDTH), COPY_WIDTH);
+                }
+                
+                tiles.resize(NEW_SIZE);
+            }
+            else {
+                tiles.resize(NEW_SIZE);
+                
+                for (int i = COPY_HEIGHT - 1; i >= 0; --i) {
+                    const size_t NEW_INDEX = fdl::containerUtil::indexFromCoords(0, i, width);
+                    memmove(tiles.data() + NEW_INDEX, tiles.data() + fdl::containerUtil::indexFromCoords(0, i, OLD_WIDTH), COPY_WIDTH);
+                    memset(tiles.data() + NEW_INDEX + COPY_WIDTH, 0, width - COPY_WIDTH); //clear the new end of the row
                 }
             }
+            
+            //rows past the old height may still hold leftover tiles
+            const size_t COPIED_SIZE = (size_t)width * COPY_HEIGHT;
+            if (NEW_SIZE > COPIED_SIZE) {
+                memset(tiles.data() + COPIED_SIZE, 0, NEW_SIZE - COPIED_SIZE);
+            }
+            
+            if (collision) {
+                collision -> rebuild();
+            }
         }
         
         void pxPack::tileLayer::setFlag(const uint8_t flag) {
@@ -64,7 +218,102 @@ namespace fdl {
         }
         
         void pxPack::tileLayer::setTile(const uint16_t x, const uint16_t y, const uint8_t tile) {
-            tiles.at(fdl::containerUtil::indexFromCoords(x, y, width)) = tile;
+            unmapTiles();
+            
+            const size_t INDEX = fdl::containerUtil::indexFromCoords(x, y, width);
+            tiles.at(INDEX) = tile;
+            
+            if (collision) { //only the one cell changes, so it's updated rather than rebuilt
+                collision -> update(INDEX, tile);
+            }
+        }
+        
+        void pxPack::tileLayer::setTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles) {
+            this -> width = width;
+            this -> height = height;
+            mappedTiles = nullptr;
+            mapping.reset();
+            //resize() and memcpy() rather than assign(), which copies tile by tile through the arena allocator
+            const size_t NUM_TILES = (size_t)width * height;
+            this -> tiles.resize(NUM_TILES);
+            if (NUM_TILES > 0) {
+                memcpy(this -> tiles.data(), tiles, NUM_TILES);
+            }
+            
+            if (collision) {
+                collision -> rebuild();
+            }
+        }
+        
+        void pxPack::tileLayer::mapTiles(const uint16_t width, const uint16_t height, const uint8_t* tiles,
+                                         std::shared_ptr <const fdl::fileUtil::mappedFile> mapping) {
+            this -> width = width;
+            this -> height = height;
+            this -> tiles.clear();
+            this -> tiles.shrink_to_fit(); //the mapping replaces the layer's own storage entirely
+            mappedTiles = tiles;
+            this -> mapping = std::move(mapping);
+            
+            if (collision) {
+                collision -> rebuild();
+            }
+        }
+        
+        void pxPack::tileLayer::fillRect(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height,
+                                         const uint8_t tile) {
+            fdl::containerUtil::fillRect(*this, x, y, width, height, tile); //updates the collision layer through rowsWritten()
+        }
+        
+        size_t pxPack::tileLayer::replaceTile(const uint8_t from, const uint8_t to) {
+            return fdl::containerUtil::replaceTile(*this, from, to);
+        }
+        
+        std::array <size_t, 256> pxPack::tileLayer::getHistogram() const {
+            return fdl::containerUtil::getHistogram(*this);
+        }
+        
+        size_t pxPack::tileLayer::countDifferences(const tileLayer& other) const {
+            return fdl::containerUtil::countDifferences(*this, other);
+        }
+        
+        void pxPack::tileLayer::remapTiles(const tileLayer& source, const std::array <uint8_t, 256>& table) {
+            if (this == &source) {
+                fdl::containerUtil::remapTiles(*this, table);
+                return;
+            }
+            
+            width = source.width;
+            height = source.height;
+            flag = source.flag;
+            mappedTiles = nullptr;
+            mapping.reset();
+            
+            tiles.resize((size_t)width * height);
+            fdl::containerUtil::remapBytes(tiles.data(), source.getTileView().data(), tiles.size(), table);
+            
+            if (collision) {
+                collision -> rebuild();
+            }
+        }
+        
+        void pxPack::tileLayer::unmapTiles() {
+            if (!isMapped()) {
+                return;
+            }
+            
+            const size_t NUM_TILES = (size_t)width * height;
+            tiles.resize(NUM_TILES);
+            if (NUM_TILES > 0) {
+                memcpy(tiles.data(), mappedTiles, NUM_TILES);
+            }
+            mappedTiles = nullptr;
+            mapping.reset();
+        }
+        
+        void pxPack::tileLayer::rowsWritten(const uint16_t firstRow, const uint16_t endRow) {
+            if (collision) {
+                collision -> rebuildRows(firstRow, endRow);
+            }
         }
     }
 }
\ No newline at end of file
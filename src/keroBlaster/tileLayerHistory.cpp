@@ -0,0 +1,199 @@
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include <cstdint>
+#include <cstring> //memcmp(const void* ptr1, const void* ptr2, size_t num), memcpy(...)
+
+#include "fdl/keroBlaster/pxPack.hpp"
+#include "fdl/keroBlaster/tileLayerHistory.hpp"
+#include "fdl/keroBlaster/collisionLayer.hpp"
+
+#include "fdl/containerUtil/arrayView.hpp"
+
+namespace fdl {
+    namespace keroBlaster {
+        constexpr size_t tileLayerHistory::CHUNK_SIZE;
+        
+        tileLayerHistory::tileLayerHistory(const pxPack::tileLayer& layer, const size_t maxVersions) : current(0),
+                                                                                                     maxVersions(maxVersions) {
+            versions.push_back(makeVersion(layer, nullptr));
+        }
+        
+        bool tileLayerHistory::commit(const pxPack::tileLayer& layer) {
+            version next = makeVersion(layer, &versions[current]);
+            
+            if (next.changedChunks.empty() && next.width == versions[current].width &&
+                next.height == versions[current].height && next.flag == versions[current].flag) {
+                return false;
+            }
+            
+            versions.erase(versions.begin() + current + 1, versions.end()); //committing after an undo drops the redo branch
+            versions.push_back(std::move(next));
+            ++current;
+            
+            if (maxVersions > 0 && versions.size() > maxVersions) {
+                versions.pop_front();
+                --current;
+                
+                //the new oldest version has nothing before it to have changed from
+                version& oldest = versions.front();
+                oldest.changedChunks.resize(oldest.chunks.size());
+                
+                for (size_t i = 0; i < oldest.chunks.size(); ++i) {
+                    oldest.changedChunks[i] = i;
+                }
+            }
+            
+            return true;
+        }
+        
+        bool tileLayerHistory::canUndo() const {
+            return current > 0;
+        }
+        
+        bool tileLayerHistory::canRedo() const {
+            return current + 1 < versions.size();
+        }
+        
+        void tileLayerHistory::undo(pxPack::tileLayer& layer) {
+            if (!canUndo()) {
+                throw std::logic_error("ERROR: Attempt to undo past the oldest version of a tile layer.");
+            }
+            
+            --current;
+            restoreFrom(layer, versions[current + 1]);
+        }
+        
+        void tileLayerHistory::redo(pxPack::tileLayer& layer) {
+            if (!canRedo()) {
+                throw std::logic_error("ERROR: Attempt to redo past the newest version of a tile layer.");
+            }
+            
+            ++current;
+            restoreFrom(layer, versions[current - 1]);
+        }
+        
+        void tileLayerHistory::restore(pxPack::tileLayer& layer) const {
+            const version& VERSION = versions[current];
+            
+            layer.width = VERSION.width;
+            layer.height = VERSION.height;
+            layer.flag = VERSION.flag;
+            layer.mappedTiles = nullptr;
+            layer.mapping.reset();
+            layer.tiles.resize((size_t)VERSION.width * VERSION.height);
+            
+            for (size_t i = 0; i < VERSION.chunks.size(); ++i) {
+                memcpy(layer.tiles.data() + i * CHUNK_SIZE, VERSION.chunks[i] -> data(), VERSION.chunks[i] -> size());
+            }
+            
+            if (layer.collision) {
+                layer.collision -> rebuild();
+            }
+        }
+        
+        void tileLayerHistory::restoreFrom(pxPack::tileLayer& layer, const version& previous) const {
+            const version& VERSION = versions[current];
+            
+            if (layer.isMapped() || layer.width != previous.width || layer.height != previous.height ||
+                VERSION.width != previous.width || VERSION.height != previous.height) { //chunks only line up between layers of the same size
+                restore(layer);
+                return;
+            }
+            
+            //chunks shared by both versions already hold the right tiles
+            size_t firstChanged = VERSION.chunks.size();
+            size_t endChanged = 0;
+            
+            for (size_t i = 0; i < VERSION.chunks.size(); ++i) {
+                if (VERSION.chunks[i] != previous.chunks[i]) {
+                    memcpy(layer.tiles.data() + i * CHUNK_SIZE, VERSION.chunks[i] -> data(), VERSION.chunks[i] -> size());
+                    firstChanged = std::min(firstChanged, i);
+                    endChanged = i + 1;
+                }
+            }
+            
+            const bool FLAG_CHANGED = (layer.flag != VERSION.flag);
+            layer.flag = VERSION.flag;
+            
+            if (!layer.collision) {
+                return;
+            }
+            
+            if (FLAG_CHANGED) {
+                layer.collision -> rebuild();
+            }
+            else if (firstChanged < endChanged) {
+                const size_t END_TILE = std::min(endChanged * CHUNK_SIZE, layer.tiles.size());
+                layer.rowsWritten(firstChanged * CHUNK_SIZE / layer.width, (END_TILE - 1) / layer.width + 1);
+            }
+        }
+        
+        size_t tileLayerHistory::getNumVersions() const {
+            return versions.size();
+        }
+        
+        size_t tileLayerHistory::getCurrentVersion() const {
+            return current;
+        }
+        
+        const std::vector <size_t>& tileLayerHistory::getChangedChunks(const size_t index) const {
+            if (index >= versions.size()) {
+                throw std::out_of_range("ERROR: Attempt to get version " + std::to_string(index) +
+                                        " of a tile layer history holding " + std::to_string(versions.size()) + " versions.");
+            }
+            
+            return versions[index].changedChunks;
+        }
+        
+        size_t tileLayerHistory::getMemoryUsage() const {
+            std::unordered_set <const std::vector <uint8_t>*> counted;
+            size_t usage = 0;
+            
+            for (const version& VERSION : versions) {
+                for (const chunkPtr& CHUNK : VERSION.chunks) {
+                    if (counted.insert(CHUNK.get()).second) {
+                        usage += CHUNK -> size();
+                    }
+                }
+            }
+            
+            return usage;
+        }
+        
+        tileLayerHistory::version tileLayerHistory::makeVersion(const pxPack::tileLayer& layer, const version* previous) {
+            const fdl::containerUtil::arrayView <const uint8_t> TILES = layer.getTileView();
+            const size_t NUM_CHUNKS = (TILES.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            
+            version next;
+            next.width = layer.getWidth();
+            next.height = layer.getHeight();
+            next.flag = layer.getFlag();
+            next.chunks.reserve(NUM_CHUNKS);
+            
+            for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+                const uint8_t* const START = TILES.data() + i * CHUNK_SIZE;
+                const size_t SIZE = std::min(CHUNK_SIZE, TILES.size() - i * CHUNK_SIZE);
+                
+                if (previous && i < previous -> chunks.size()) {
+                    const chunkPtr& OLD = previous -> chunks[i];
+                    
+                    if (OLD -> size() == SIZE && 0 == memcmp(OLD -> data(), START, SIZE)) {
+                        next.chunks.push_back(OLD);
+                        continue;
+                    }
+                }
+                
+                next.chunks.push_back(std::make_shared <const std::vector <uint8_t>>(START, START + SIZE));
+                next.changedChunks.push_back(i);
+            }
+            
+            return next;
+        }
+    }
+}
\ No newline at end of file